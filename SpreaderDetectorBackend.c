@@ -18,277 +18,91 @@
  */
 
 //-----------------------------------------  includes  ---------------------------------------------
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include "SpreaderDetectorParams.h"
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "SpreaderDetectorBackend.h"
 
-//-------------------------------------  const definitions  ----------------------------------------
-/**
- * @def SUCCESS- a declaration for success in a function.
- */
-#define SUCCESS 1
-
-/**
- * @def FAILURE- a declaration for failure in a function.
- */
-#define FAILURE 0
-
-/**
- * @def ARGS_AMOUNT- the number of arguments in argv[]
- */
-#define ARGS_AMOUNT 3
-
-/**
- * @def PEOPLE_FILE_INDEX- the people's file index in argv[]
- */
-#define PEOPLE_FILE_INDEX 1
-
-/**
- * @def MEETINGS_FILE_INDEX- the meetings' file index in argv[]
- */
-#define MEETINGS_FILE_INDEX 2
-
-/**
- * @def SEPARATOR- the character that separates the fields in each line in the files
- */
-#define SEPARATOR " "
-
-/**
- * @def ALLOC_SIZE- the default size of  memory allocation
- */
-#define ALLOC_SIZE 2
-
-/**
- * @def DECIMAL_BASE- a numeric base for the int convertion
- */
-#define DECIMAL_BASE 10
-
-/**
- * @def EPSILON- the accuracy for float comparision
- */
-#define EPSILON 0.000000001
-
-/**
- * @def EQUAL- the objects are equal
- */
-#define EQUAL 0
-
-/**
- * @def GREATER- the first object greater than the second one
- */
-#define GREATER 1
-
-/**
- * @def SMALLER- the first object smaller than the second one
- */
-#define SMALLER -1
-
-/**
- * @def USAGE_ERROR- the massage to print when there is a usage error
- */
-#define USAGE_ERROR "USAGE: ./SpreaderDetectorBackend <Path to People.in> <Path to Meetings.in>\n"
-
-/**
- * @def IN_FILE_ERROR- the massage to print when there is an error in the input files
- */
-#define IN_FILE_ERROR "Error in input files.\n"
-
-/**
- * @def OUT_FILE_ERROR- the massage to print when there is an error in opening the output file
- */
-#define OUT_FILE_ERROR "Error in output file.\n"
-
-/**
- * @def MAX_LINE_LENGTH- the maximum length for each line in the file
- */
-#define MAX_LINE_LENGTH 1024
-
-/**
- * @def Person- a struct that contains information about a person: name (dinamically allocates array
- * of chars), id, age and the probability to get infected
- */
-typedef struct Person
-{
-	char *name;
-	unsigned long int id;
-	float age;
-	float probability;
-} Person;
-
-/**
- * @def compFunc- a typdef to a function that compares two persons
- */
-typedef int (*compFunc)(const Person, const Person);
-
-//-----------------------------------------  functions  --------------------------------------------
-/**
- * This function is responsible to free the array of Person's structs, including the name field in
- * each struct
- * @param peopleList - the array of structs
- * @param length - the length of the array
- */
-void freePeople(Person *peopleList, int length);
-
-/**
- * This function is doing the required actions before exiting the program with EXIT_FAILURE code.
- * @param fileToClose - a pointer to the file needed to be closed. NULL if there isn't any open file
- * @param errorToPrint - the error needed to be print to the stderr
- * @param peopleList - the array of Persons needed to be freed. NULL if the array doesn't exist
- * @param peopleListSize - the size of the array
- */
-void beforeExitFailure(FILE *fileToClose, const char *errorToPrint, Person *peopleList,
-					   int peopleListSize);
-
-/**
- * This function checks if the amount of arguments is ok
- * @param argc - the amount of arguments in the program
- * @return - 1 if succeeded, 0 if failed
- */
-int argcCheck(int argc);
-
-/**
- * This function calculates the probability for infection between two people
- * @param dist - the distance between them in their meeting (float)
- * @param time - the duration of their meeting (float)
- * @return a float with the probability
- */
-float crna(float dist, float time);
-
-/**
- * This function compares between two persons' id
- * @param a - the first Person
- * @param b - the second Person
- * @return - 1 if a is greater, -1 if a is smaller, 0 if a and b are equal
- */
-int idCompare(Person a, Person b);
-
-/**
- * This function compares between two persons' probability of infection
- * @param a - the first Person
- * @param b - the second Person
- * @return - 1 if a is greater, -1 if a is smaller, 0 if a and b are equal
- */
-int probCompare(Person a, Person b);
-
-/**
- * Merges two sorted sub-arrays into one sorted array
- * @param peopleList - the main array to sort
- * @param a - a pointer to the first sub-array
- * @param aLen - the length of the first sub-array
- * @param b - a pointer to the second sub-array
- * @param bLen - the length of the second sub-array
- * @param start - the index (in the original list) to start with
- * @param comp - a compare function
- */
-void merge(Person *peopleList, Person *a, int aLen, Person *b, int bLen, int start, compFunc comp);
+//-------------------------------------------- code  -----------------------------------------------
 
 /**
- * Sorts the people's list, using the Merge-Sort algorithm
- * @param peopleList - the main array to sort
- * @param draftList - an array of structs (type Person)
- * @param length - an int with the length of the array
- * @param start - an int with the index to start with (in the original list)
- * @param comp - a compare function
+ * Set when the server should stop accepting requests
  */
-void mergeSort(Person *peopleList, Person *draftList, int length, int start, compFunc comp);
+static volatile sig_atomic_t serverStopped = 0;
 
-/**
- * This function sorts an array of struct Person by the id attribute
- * @param peopleList - the array to sort
- * @param peopleListSize - the length of the array
- * @return nothing, if fails- frees all memory and exits the program
- */
-void sortById(Person **peopleList, int peopleListSize);
+Stats stats;
 
-/**
- * This function sorts an array of struct Person by the probability attribute
- * @param peopleList - the array to sort
- * @param peopleListSize - the length of the array
- * @return nothing, if fails- frees all memory and exits the program
- */
-void sortByProbability(Person **peopleList, int peopleListSize);
+PerfCounters perf;
 
 /**
- * This function gets an array of struct Person sorted by id and an id to search in it, and finds
- * the index of the id in the array
- * @param peopleList - the array to search in
- * @param idToFind - the id to search
- * @param start - the start index
- * @param end - the end index
- * @return - the index of the desired id in the array
+ * The names of the hardware counters, as printed in the report of perf mode
  */
-int binarySearchById(Person *peopleList, unsigned long int idToFind, int start, int end);
+static const char *const perfEventNames[PERF_EVENTS] = {"cycles", "instructions", "LLC misses",
+														"branch misses"};
 
-/**
- * This function gets an empty struct of type Person and a line with information, and fills the
- * struct's fields
- * @param line - a string with the information from the file
- * @param person - the struct to fill
- * @return 1 if succeeded, 0 if failed
- */
-int fillPerson(char *line, Person *person);
+Tracer tracer;
 
-/**
- * This function reads the people's file and put the data in an array of struct Person
- * @param peopleFile - pointer to the people's file
- * @param peopleList - type Person**, a pointer to the array to fill
- * @return an int with the number of people in the file (and in the array). if fails- frees all
- * memory and exits the program
- */
-int readPeopleFile(FILE *peopleFile, Person **peopleList);
+Alerter alerter;
 
 /**
- * This function allocates more memory to the array of struct Person, using realloc
- * @param peopleList - the array of struct Person
- * @param capacity - the new size for the array
- * @param counter - the current size of the array
- * @param peopleFile - a pointer to the people's file
+ * The names of the classifications, as written in the alerts
  */
-void allocateMore(Person **peopleList, int capacity, int counter, FILE *peopleFile);
+static const char *const classNames[] = {"CLEAN", "QUARANTINE", "HOSPITALIZATION"};
 
 /**
- * This function reads the data from the meetings' file and accordingly updates the array of Persons
- * @param meetingsFile - the meetings' file
- * @param peopleList - the array to update
- * @param peopleListSize - the size of the array
+ * The trace buffer of every thread, registered at the thread's first event
  */
-void readMeetingsFile(FILE *meetingsFile, Person *peopleList, int peopleListSize);
+static __thread TraceBuffer *threadTrace = NULL;
 
 /**
- * This function calculates the probability for a certain Person (taken from a line) and updates it
- * in its struct
- * @param peopleList - the array of Persons
- * @param peopleListSize - the size of the array
- * @param line - a string with the line from the meetings' file
+ * The names of the phases, as printed in the report of stats mode
  */
-void probUpdater(Person *peopleList, int peopleListSize, char *line);
+static const char *const phaseNames[PHASE_AMOUNT] = {"readPeopleFile", "sortById",
+													 "readMeetingsFile", "sortByProbability",
+													 "writeOutput", "runBatch"};
 
 /**
- * This function is responsible to write to the output file the medical conclusions for the people
- * in the program by their probability of infection
- * @param outputFile - the file to write to
- * @param peopleList - the array of struct Person
- * @param peopleListSize - the size of the array
+ * The names of the subsystems, as printed in the report of stats mode
  */
-void writeOutput(FILE *outputFile, Person *peopleList, int peopleListSize);
-
-//-------------------------------------------- code  -----------------------------------------------
+static const char *const memoryNames[MEMORY_AMOUNT] = {"people", "names", "sort drafts",
+													   "propagation", "indexes", "pipeline",
+													   "classes"};
 
-void freePeople(Person *peopleList, int length)
+void freePeople(Person *peopleList, size_t length)
 {
-	for (int i = 0; i < length; ++i)
+	uint64_t namesBytes = 0;
+	for (size_t i = 0; i < length; ++i)
 	{
+		if (stats.enabled && peopleList[i].name != NULL)
+		{
+			namesBytes += strlen(peopleList[i].name) + 1;
+		}
 		free(peopleList[i].name);
 		peopleList[i].name = NULL;
 	}
+	trackMemory(MEMORY_NAMES, namesBytes, 0);
+	// there is a single people's array, so all of the subsystem's memory is released
+	trackMemory(MEMORY_PEOPLE, stats.memory[MEMORY_PEOPLE].live, 0);
 	free(peopleList);
 	peopleList = NULL;
 }
 
 void beforeExitFailure(FILE *fileToClose, const char *errorToPrint, Person *peopleList,
-					   int peopleListSize)
+					   size_t peopleListSize)
 {
 	fprintf(stderr, "%s", errorToPrint);
 	if (peopleList != NULL)
@@ -312,13 +126,16 @@ int idCompare(const Person a, const Person b)
 {
 	const unsigned long int id1 = a.id;
 	const unsigned long int id2 = b.id;
-	return id1 - id2;
+	return (id1 > id2) - (id1 < id2); // the difference of two ids may not fit in an int
 }
 
 int probCompare(const Person a, const Person b)
 {
-	const float id1 = a.probability;
-	const float id2 = b.probability;
+	return compareProbabilities(a.probability, b.probability);
+}
+
+int compareProbabilities(const float id1, const float id2)
+{
 	if (fabsf(id1 - id2) < EPSILON)
 	{
 		return EQUAL;
@@ -333,10 +150,11 @@ int probCompare(const Person a, const Person b)
 	}
 }
 
-void merge(Person *peopleList, Person *a, int aLen, Person *b, int bLen, int start, compFunc comp)
+void merge(Person *peopleList, Person *a, size_t aLen, Person *b, size_t bLen, size_t start,
+		   compFunc comp)
 {
-	int aI = 0;
-	int bI = 0;
+	size_t aI = 0;
+	size_t bI = 0;
 	while (aI < aLen && bI < bLen)
 	{
 		if (comp(a[aI], b[bI]) < 0)
@@ -352,39 +170,142 @@ void merge(Person *peopleList, Person *a, int aLen, Person *b, int bLen, int sta
 	}
 	if (aI < aLen)
 	{
-		for (int i = aI; i < aLen; i++)
+		for (size_t i = aI; i < aLen; i++)
 		{
 			peopleList[start + i + bI] = a[i];
 		}
 	}
 	else
 	{
-		for (int j = bI; j < bLen; j++)
+		for (size_t j = bI; j < bLen; j++)
 		{
 			peopleList[start + aI + j] = b[j];
 		}
 	}
 }
 
-void mergeSort(Person *peopleList, Person *draftList, int length, int start, compFunc comp)
+void mergeSort(Person *peopleList, Person *draftList, size_t length, size_t start, compFunc comp)
 {
 	if (length < 1)
 	{
 		return;
 	}
-	int aLen = length / 2;
-	int bLen = length - aLen;
+	size_t aLen = length / 2;
+	size_t bLen = length - aLen;
 	if (aLen == 0)
 	{
 		bLen = 0;
 	}
 	mergeSort(peopleList, draftList, aLen, start, comp);
 	mergeSort(peopleList, &draftList[aLen], bLen, aLen + start, comp);
-	for (int i = 0; i < (length); i++)
+	double mergeStart = length >= TRACE_CHUNK ? traceNow() : 0;
+	for (size_t i = 0; i < (length); i++)
 	{
 		draftList[i] = peopleList[i + start];
 	}
 	merge(peopleList, draftList, aLen, &draftList[aLen], bLen, start, comp);
+	if (length >= TRACE_CHUNK)
+	{
+		traceSpan("merge", "sort", mergeStart, (long) length);
+	}
+}
+
+void mergeSortById(Person *peopleList, Person *draftList, size_t length, size_t start)
+{
+	if (length < 1)
+	{
+		return;
+	}
+	size_t aLen = length / 2;
+	size_t bLen = length - aLen;
+	if (aLen == 0)
+	{
+		bLen = 0;
+	}
+	mergeSortById(peopleList, draftList, aLen, start);
+	mergeSortById(peopleList, &draftList[aLen], bLen, aLen + start);
+	double mergeStart = length >= TRACE_CHUNK ? traceNow() : 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		draftList[i] = peopleList[i + start];
+	}
+	const Person *a = draftList;
+	const Person *b = &draftList[aLen];
+	size_t aI = 0;
+	size_t bI = 0;
+	// the ids are compared here and not by idCompare(), since a call for every element costs more
+	// than the merge itself
+	while (aI < aLen && bI < bLen)
+	{
+		if (a[aI].id < b[bI].id)
+		{
+			peopleList[start + aI + bI] = a[aI];
+			aI++;
+		}
+		else
+		{
+			peopleList[start + aI + bI] = b[bI];
+			bI++;
+		}
+	}
+	for (; aI < aLen; aI++)
+	{
+		peopleList[start + aI + bI] = a[aI];
+	}
+	for (; bI < bLen; bI++)
+	{
+		peopleList[start + aI + bI] = b[bI];
+	}
+	if (length >= TRACE_CHUNK)
+	{
+		traceSpan("merge", "sort", mergeStart, (long) length);
+	}
+}
+
+void mergeSortRows(RowIndex *const rows, RowIndex *const draftRows, size_t length, size_t start,
+				   const float *const probabilities)
+{
+	if (length < 1)
+	{
+		return;
+	}
+	size_t aLen = length / 2;
+	size_t bLen = length - aLen;
+	if (aLen == 0)
+	{
+		bLen = 0;
+	}
+	mergeSortRows(rows, draftRows, aLen, start, probabilities);
+	mergeSortRows(rows, &draftRows[aLen], bLen, aLen + start, probabilities);
+	for (size_t i = 0; i < length; i++)
+	{
+		draftRows[i] = rows[i + start];
+	}
+	const RowIndex *a = draftRows;
+	const RowIndex *b = &draftRows[aLen];
+	size_t aI = 0;
+	size_t bI = 0;
+	while (aI < aLen && bI < bLen)
+	{
+		if (compareProbabilities(probabilities[a[aI]], probabilities[b[bI]]) < 0)
+		{
+			rows[start + aI + bI] = a[aI];
+			aI++;
+		}
+		else
+		{
+			rows[start + aI + bI] = b[bI];
+			bI++;
+		}
+	}
+	for (; aI < aLen; aI++)
+	{
+		rows[start + aI + bI] = a[aI];
+	}
+	for (; bI < bLen; bI++)
+	{
+		rows[start + aI + bI] = b[bI];
+	}
 }
 
 int fillPerson(char *line, Person *const person)
@@ -395,14 +316,15 @@ int fillPerson(char *line, Person *const person)
 	{
 		return FAILURE;
 	}
+	trackMemory(MEMORY_NAMES, 0, strlen(temp) + 1);
 	strcpy(person->name, temp); // copy name into person
-	person->id = strtol(strtok(NULL, SEPARATOR), NULL, DECIMAL_BASE);
+	person->id = strtoul(strtok(NULL, SEPARATOR), NULL, DECIMAL_BASE);
 	person->age = strtof(strtok(NULL, SEPARATOR), NULL);
 	person->probability = 0;
 	return SUCCESS;
 }
 
-void allocateMore(Person **peopleList, int capacity, int counter, FILE *peopleFile)
+void allocateMore(Person **peopleList, size_t capacity, size_t counter, FILE *peopleFile)
 {
 	Person *tempList = (Person *) realloc(*peopleList, sizeof(Person) * capacity);
 	if (tempList == NULL)
@@ -410,22 +332,30 @@ void allocateMore(Person **peopleList, int capacity, int counter, FILE *peopleFi
 		beforeExitFailure(peopleFile, STANDARD_LIB_ERR_MSG, *peopleList, counter);
 		exit(EXIT_FAILURE);
 	}
+	trackMemory(MEMORY_PEOPLE, sizeof(Person) * (capacity / ALLOC_SIZE), sizeof(Person) * capacity);
 	*peopleList = tempList;
 }
 
-int readPeopleFile(FILE *peopleFile, Person **peopleList)
+size_t readPeopleFile(FILE *peopleFile, Person **peopleList)
 {
-	int capacity = ALLOC_SIZE;
+	size_t capacity = ALLOC_SIZE;
 	*peopleList = (Person *) calloc(sizeof(Person), capacity);
 	if (*peopleList == NULL)
 	{
 		beforeExitFailure(peopleFile, STANDARD_LIB_ERR_MSG, NULL, 0);
 		exit(EXIT_FAILURE);
 	}
+	trackMemory(MEMORY_PEOPLE, 0, sizeof(Person) * capacity);
 	char line[MAX_LINE_LENGTH];
-	int personsCounter = 0;
+	size_t personsCounter = 0;
+	uint64_t allocations = 1;
 	while (fgets(line, MAX_LINE_LENGTH, peopleFile))
 	{
+		if (personsCounter == MAX_PEOPLE) // the next row wouldn't fit in a RowIndex
+		{
+			beforeExitFailure(peopleFile, TOO_MANY_PEOPLE_ERROR, *peopleList, personsCounter);
+			exit(EXIT_FAILURE);
+		}
 		Person person;
 		int fillResult = fillPerson(line, &person);
 		if (fillResult == FAILURE)
@@ -439,8 +369,12 @@ int readPeopleFile(FILE *peopleFile, Person **peopleList)
 		{
 			capacity *= ALLOC_SIZE;
 			allocateMore(peopleList, capacity, personsCounter, peopleFile);
+			++allocations;
 		}
 	}
+	statsAdd(&stats.rowsParsed, personsCounter);
+	statsAdd(&stats.allocations, allocations + personsCounter); // and a name for every person
+	statsAdd(&stats.bytesRead, fileOffset(peopleFile));
 	if (fclose(peopleFile) == EOF)
 	{
 		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, *peopleList, personsCounter);
@@ -449,7 +383,7 @@ int readPeopleFile(FILE *peopleFile, Person **peopleList)
 	return personsCounter;
 }
 
-void sortById(Person **peopleList, int peopleListSize)
+void sortById(Person **peopleList, size_t peopleListSize)
 {
 	Person *draft = (Person *) calloc(sizeof(Person), peopleListSize);
 	if (draft == NULL)
@@ -457,12 +391,15 @@ void sortById(Person **peopleList, int peopleListSize)
 		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, *peopleList, peopleListSize);
 		exit(EXIT_FAILURE);
 	}
-	mergeSort(*peopleList, draft, peopleListSize, 0, idCompare);
+	trackMemory(MEMORY_SORT, 0, sizeof(Person) * peopleListSize);
+	mergeSortById(*peopleList, draft, peopleListSize, 0);
+	statsAdd(&stats.allocations, 1);
+	trackMemory(MEMORY_SORT, sizeof(Person) * peopleListSize, 0);
 	free(draft);
 	draft = NULL;
 }
 
-void sortByProbability(Person **peopleList, int peopleListSize)
+void sortByProbability(Person **peopleList, size_t peopleListSize)
 {
 	Person *draft = (Person *) calloc(sizeof(Person), peopleListSize);
 	if (draft == NULL)
@@ -470,132 +407,3239 @@ void sortByProbability(Person **peopleList, int peopleListSize)
 		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, *peopleList, peopleListSize);
 		exit(EXIT_FAILURE);
 	}
+	trackMemory(MEMORY_SORT, 0, sizeof(Person) * peopleListSize);
 	mergeSort(*peopleList, draft, peopleListSize, 0, probCompare);
+	statsAdd(&stats.allocations, 1);
+	trackMemory(MEMORY_SORT, sizeof(Person) * peopleListSize, 0);
 	free(draft);
 	draft = NULL;
 }
 
-int binarySearchById(Person *const peopleList, unsigned long int idToFind, int start, int end)
+int parseMeeting(Person *const peopleList, size_t peopleListSize, char *line,
+				 MeetingRecord *const meeting)
+{
+	char *rest = NULL; // strtok_r(), so meetings can be parsed by many threads
+	unsigned long int infectorId = strtoul(strtok_r(line, SEPARATOR, &rest), NULL, DECIMAL_BASE);
+	unsigned long int infectedId = strtoul(strtok_r(NULL, SEPARATOR, &rest), NULL, DECIMAL_BASE);
+	meeting->infectorRow = findRow(peopleList, peopleListSize, infectorId);
+	meeting->infectedRow = findRow(peopleList, peopleListSize, infectedId);
+	meeting->distance = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+	meeting->time = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+	return meeting->infectorRow != NOT_FOUND && meeting->infectedRow != NOT_FOUND;
+}
+
+RowIndex probUpdater(Person *const peopleList, size_t peopleListSize, char *line)
+{
+	MeetingRecord meeting;
+	if (parseMeeting(peopleList, peopleListSize, line, &meeting) == FAILURE)
+	{
+		return NOT_FOUND;
+	}
+	float prob = crna(meeting.distance, meeting.time);
+	peopleList[meeting.infectedRow].probability =
+			peopleList[meeting.infectorRow].probability * prob;
+	return meeting.infectedRow;
+}
+
+FILE *openMeetingsFile(const char *path, const char *mode)
+{
+	if (strcmp(path, STDIN_PATH) == 0)
+	{
+		return stdin;
+	}
+	return fopen(path, mode);
+}
+
+uint64_t applyMeetings(FILE *meetingsFile, Person *const peopleList, size_t peopleListSize,
+					   uint64_t applied, int wholeLines)
 {
-	int mid = start + ((end - start) / 2);
-	if (peopleList[mid].id == idToFind)
+	char line[MAX_LINE_LENGTH];
+	uint64_t meetings = applied;
+	double chunkStart = traceNow();
+	while (fgets(line, MAX_LINE_LENGTH, meetingsFile))
 	{
-		return mid;
+		size_t length = strlen(line);
+		if (wholeLines && line[length - 1] != '\n')
+		{
+			// the line may still be appended to, so the file is left before it
+			if (fseek(meetingsFile, -(long) length, SEEK_CUR) != 0)
+			{
+				beforeExitFailure(meetingsFile, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		}
+		RowIndex infectedRow = probUpdater(peopleList, peopleListSize, line);
+		if (infectedRow == NOT_FOUND)
+		{
+			beforeExitFailure(meetingsFile, IN_FILE_ERROR, peopleList, peopleListSize);
+			exit(EXIT_FAILURE);
+		}
+		++meetings;
+		if (alerter.file != NULL)
+		{
+			alertIfCrossed(peopleList, infectedRow, meetings);
+		}
+		if (tracer.enabled && meetings % TRACE_CHUNK == 0)
+		{
+			traceSpan("meetings chunk", "meetings", chunkStart, (long) (meetings / TRACE_CHUNK));
+			chunkStart = traceNow();
+		}
 	}
-	if (peopleList[mid].id > idToFind) // id is smaller than the middle id
+	traceSpan("meetings chunk", "meetings", chunkStart, (long) (meetings / TRACE_CHUNK + 1));
+	return meetings;
+}
+
+int meetingsTailHash(FILE *meetingsFile, uint64_t offset, uint64_t *const hash)
+{
+	uint64_t tailLength = offset < CHECKPOINT_TAIL ? offset : CHECKPOINT_TAIL;
+	unsigned char tail[CHECKPOINT_TAIL];
+	if (fseek(meetingsFile, (long) (offset - tailLength), SEEK_SET) != 0 ||
+		fread(tail, 1, tailLength, meetingsFile) != tailLength)
 	{
-		return binarySearchById(peopleList, idToFind, start, mid - 1);
+		return FAILURE;
 	}
-	else // id is greater than the middle id
+	*hash = CHECKSUM_BASIS;
+	for (uint64_t i = 0; i < tailLength; ++i)
 	{
-		return binarySearchById(peopleList, idToFind, mid + 1, end);
+		*hash ^= tail[i];
+		*hash *= CHECKSUM_PRIME;
 	}
+	return SUCCESS;
 }
 
-void probUpdater(Person *const peopleList, int peopleListSize, char *line)
+FILE *openReplacement(const char *path, char **tempPath)
 {
-	unsigned long int infectorId = strtol(strtok(line, SEPARATOR), NULL, DECIMAL_BASE);
-	unsigned long int infectedId = strtol(strtok(NULL, SEPARATOR), NULL, DECIMAL_BASE);
-	int infectorIdx = binarySearchById(peopleList, infectorId, 0, peopleListSize - 1);
-	int infectedIdx = binarySearchById(peopleList, infectedId, 0, peopleListSize - 1);
-	float distance = strtof(strtok(NULL, SEPARATOR), NULL);
-	float time = strtof(strtok(NULL, SEPARATOR), NULL);
-	float prob = crna(distance, time);
-	peopleList[infectedIdx].probability = peopleList[infectorIdx].probability * prob;
+	*tempPath = (char *) malloc(strlen(path) + strlen(TEMP_FILE_SUFFIX) + 1);
+	if (*tempPath == NULL)
+	{
+		return NULL;
+	}
+	strcat(strcpy(*tempPath, path), TEMP_FILE_SUFFIX);
+	return fopen(*tempPath, "wb");
 }
 
-void readMeetingsFile(FILE *meetingsFile, Person *const peopleList, int peopleListSize)
+int replaceFile(FILE *file, char *tempPath, const char *path, int written)
 {
-	char line[MAX_LINE_LENGTH];
-	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) == NULL) //if file is empty, close it and return
+	int replaced = file != NULL && fclose(file) != EOF && written && rename(tempPath, path) == 0;
+	if (file != NULL && !replaced)
 	{
-		if (fclose(meetingsFile) == EOF)
+		remove(tempPath);
+	}
+	free(tempPath);
+	return replaced;
+}
+
+int loadCheckpoint(const char *path, FILE *meetingsFile, Person *const peopleList,
+				   size_t peopleListSize, CheckpointHeader *const header)
+{
+	FILE *checkpoint = fopen(path, "rb");
+	if (checkpoint == NULL) // the first run
+	{
+		return FAILURE;
+	}
+	uint64_t hash = 0;
+	int loaded = fread(header, sizeof(CheckpointHeader), 1, checkpoint) == 1 &&
+				 header->magic == CHECKPOINT_MAGIC && header->version == CHECKPOINT_VERSION &&
+				 header->peopleCount == (uint64_t) peopleListSize &&
+				 header->peopleChecksum == peopleChecksum(peopleList, peopleListSize) &&
+				 meetingsTailHash(meetingsFile, header->meetingsOffset, &hash) &&
+				 hash == header->meetingsTailHash;
+	for (size_t i = 0; loaded && i < peopleListSize; ++i)
+	{
+		loaded = fread(&peopleList[i].probability, sizeof(float), 1, checkpoint) == 1;
+	}
+	fclose(checkpoint);
+	if (!loaded)
+	{
+		fprintf(stderr, CHECKPOINT_MISMATCH_MSG);
+		for (size_t i = 0; i < peopleListSize; ++i)
 		{
-			fprintf(stderr, STANDARD_LIB_ERR_MSG);
+			peopleList[i].probability = 0;
 		}
-		return;
+		rewind(meetingsFile);
 	}
-	unsigned long int sickId = strtol(line, NULL, DECIMAL_BASE);
-	int sickPersonIndex = binarySearchById(peopleList, sickId, 0, peopleListSize - 1);
-	peopleList[sickPersonIndex].probability = 1;
-	while (fgets(line, MAX_LINE_LENGTH, meetingsFile))
+	return loaded;
+}
+
+int saveCheckpoint(const char *path, FILE *meetingsFile, Person *const peopleList,
+				   size_t peopleListSize, uint64_t applied)
+{
+	long offset = ftell(meetingsFile);
+	CheckpointHeader header = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION, peopleListSize,
+							   peopleChecksum(peopleList, peopleListSize), (uint64_t) offset, 0,
+							   applied};
+	// the tail of an empty file is empty, and its hash is just the basis
+	if (offset < 0 || meetingsTailHash(meetingsFile, offset, &header.meetingsTailHash) == FAILURE)
 	{
-		probUpdater(peopleList, peopleListSize, line);
+		return FAILURE;
 	}
-	if (fclose(meetingsFile) == EOF)
+	char *tempPath = NULL;
+	FILE *checkpoint = openReplacement(path, &tempPath);
+	int saved = checkpoint != NULL &&
+				fwrite(&header, sizeof(CheckpointHeader), 1, checkpoint) == 1;
+	for (size_t i = 0; saved && i < peopleListSize; ++i)
 	{
-		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
-		exit(EXIT_FAILURE);
+		saved = fwrite(&peopleList[i].probability, sizeof(float), 1, checkpoint) == 1;
 	}
+	return replaceFile(checkpoint, tempPath, path, saved);
 }
 
-void writeOutput(FILE *outputFile, Person *const peopleList, int peopleListSize)
+void readMeetingsFileIncremental(FILE *meetingsFile, Person *const peopleList,
+								 size_t peopleListSize, const char *checkpointPath)
 {
-	for (int i = peopleListSize - 1; i >= 0; --i)
+	CheckpointHeader header;
+	uint64_t applied = 0;
+	uint64_t startOffset = 0;
+	if (loadCheckpoint(checkpointPath, meetingsFile, peopleList, peopleListSize, &header))
 	{
-		if (peopleList[i].probability >= MEDICAL_SUPERVISION_THRESHOLD ||
-			fabsf(peopleList[i].probability - MEDICAL_SUPERVISION_THRESHOLD) < EPSILON)
+		applied = header.meetingsApplied;
+		startOffset = header.meetingsOffset;
+		for (size_t i = 0; alerter.file != NULL && i < peopleListSize; ++i)
 		{
-			fprintf(outputFile, MEDICAL_SUPERVISION_THRESHOLD_MSG, peopleList[i].name,
-					peopleList[i].id);
+			// only what changes since the last run is alerted
+			alerter.classes[i] = classify(peopleList[i].probability);
 		}
-		else if (peopleList[i].probability >= REGULAR_QUARANTINE_THRESHOLD ||
-				 fabsf(peopleList[i].probability - REGULAR_QUARANTINE_THRESHOLD) < EPSILON)
+	}
+	if (startOffset == 0) // a new file, or the checkpoint of an empty one: the sick person is next
+	{
+		char line[MAX_LINE_LENGTH];
+		if (fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
 		{
-			fprintf(outputFile, REGULAR_QUARANTINE_MSG, peopleList[i].name, peopleList[i].id);
+			RowIndex sickRow = findRow(peopleList, peopleListSize,
+									   strtoul(line, NULL, DECIMAL_BASE));
+			if (sickRow == NOT_FOUND)
+			{
+				beforeExitFailure(meetingsFile, IN_FILE_ERROR, peopleList, peopleListSize);
+				exit(EXIT_FAILURE);
+			}
+			peopleList[sickRow].probability = 1;
+			if (alerter.file != NULL)
+			{
+				alertIfCrossed(peopleList, sickRow, 0);
+			}
+			statsAdd(&stats.rowsParsed, 1);
+			statsAdd(&stats.lookups, 1);
 		}
-		else
+	}
+	uint64_t meetings = applyMeetings(meetingsFile, peopleList, peopleListSize, applied, SUCCESS);
+	statsAdd(&stats.rowsParsed, meetings - applied);
+	statsAdd(&stats.meetingsApplied, meetings - applied);
+	statsAdd(&stats.lookups, 2 * (meetings - applied));
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile) - startOffset);
+	if (saveCheckpoint(checkpointPath, meetingsFile, peopleList, peopleListSize, meetings) ==
+		FAILURE)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	// a last line without its line end isn't in the checkpoint, but a whole meeting there is still
+	// in the output, as in a regular run of the file (a part of a meeting is just left for later)
+	char line[MAX_LINE_LENGTH];
+	MeetingRecord meeting;
+	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL &&
+		resolveMeeting(peopleList, peopleListSize, line, &meeting))
+	{
+		peopleList[meeting.infectedRow].probability =
+				peopleList[meeting.infectorRow].probability * crna(meeting.distance, meeting.time);
+		if (alerter.file != NULL)
 		{
-			fprintf(outputFile, CLEAN_MSG, peopleList[i].name, peopleList[i].id);
+			alertIfCrossed(peopleList, meeting.infectedRow, meetings + 1);
 		}
+		statsAdd(&stats.meetingsApplied, 1);
 	}
-	if (fclose(outputFile) == EOF)
+	if (fclose(meetingsFile) == EOF)
 	{
 		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
 		exit(EXIT_FAILURE);
 	}
 }
 
-int argcCheck(int argc)
+void loadClasses(const char *path, Person *const peopleList, size_t peopleListSize,
+				 unsigned char *const classes)
 {
-	if (argc != ARGS_AMOUNT)  // ERROR- wrong number of arguments
+	memset(classes, CLEAN, peopleListSize);
+	FILE *classesFile = fopen(path, "rb");
+	if (classesFile == NULL) // the first run, nobody was classified before
 	{
-		fprintf(stderr, USAGE_ERROR);
-		return FAILURE;
+		return;
+	}
+	ClassesHeader header;
+	int loaded = fread(&header, sizeof(ClassesHeader), 1, classesFile) == 1 &&
+				 header.magic == CLASSES_MAGIC && header.version == CLASSES_VERSION &&
+				 header.peopleCount == (uint64_t) peopleListSize &&
+				 header.peopleChecksum == peopleChecksum(peopleList, peopleListSize) &&
+				 fread(classes, 1, peopleListSize, classesFile) == peopleListSize;
+	fclose(classesFile);
+	if (!loaded)
+	{
+		fprintf(stderr, CLASSES_MISMATCH_MSG);
+		memset(classes, UNKNOWN_CLASS, peopleListSize);
 	}
-	return SUCCESS;
 }
 
-int main(int argc, char *argv[])
+int saveClasses(const char *path, Person *const peopleList, size_t peopleListSize,
+				const unsigned char *classes)
 {
-	if (argcCheck(argc) == FAILURE)
-	{
-		return EXIT_FAILURE;
-	}
-	FILE *peopleFile = fopen(argv[PEOPLE_FILE_INDEX], "r");
-	if (peopleFile == NULL)
+	ClassesHeader header = {CLASSES_MAGIC, CLASSES_VERSION, peopleListSize,
+							peopleChecksum(peopleList, peopleListSize)};
+	char *tempPath = NULL;
+	FILE *classesFile = openReplacement(path, &tempPath);
+	int saved = classesFile != NULL &&
+				fwrite(&header, sizeof(ClassesHeader), 1, classesFile) == 1 &&
+				fwrite(classes, 1, peopleListSize, classesFile) == peopleListSize;
+	return replaceFile(classesFile, tempPath, path, saved);
+}
+
+size_t writeDeltaOutput(FILE *outputFile, const char *classesPath, Person *const peopleList,
+						size_t peopleListSize)
+{
+	unsigned char *classes = (unsigned char *) malloc(peopleListSize + 1);
+	if (classes == NULL)
 	{
-		fprintf(stderr, IN_FILE_ERROR);
-		return EXIT_FAILURE;
+		beforeExitFailure(outputFile, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
 	}
-	Person *peopleList = NULL;
-	int peopleListSize = readPeopleFile(peopleFile, &peopleList); //after this, peopleFile is closed
-	sortById(&peopleList, peopleListSize); // so it would be quicker to update the probabilities
-	FILE *meetingsFile = fopen(argv[MEETINGS_FILE_INDEX], "r");
-	if (meetingsFile == NULL)
+	trackMemory(MEMORY_CLASSES, 0, peopleListSize + 1);
+	loadClasses(classesPath, peopleList, peopleListSize, classes);
+	size_t changed = 0;
+	for (size_t i = 0; i < peopleListSize; ++i)
 	{
-		beforeExitFailure(NULL, IN_FILE_ERROR, peopleList, peopleListSize);
-		return EXIT_FAILURE;
+		Classification classification = classify(peopleList[i].probability);
+		if (classification != classes[i])
+		{
+			writePerson(outputFile, &peopleList[i], peopleList[i].probability);
+			classes[i] = classification;
+			++changed;
+		}
 	}
-	readMeetingsFile(meetingsFile, peopleList, peopleListSize); //after this, meetingsFile's closed
-	sortByProbability(&peopleList, peopleListSize); // so we know what order to print in
-	FILE *outputFile = fopen(OUTPUT_FILE, "w");
-	if (outputFile == NULL)
+	statsAdd(&stats.bytesWritten, fileOffset(outputFile));
+	int saved = saveClasses(classesPath, peopleList, peopleListSize, classes);
+	trackMemory(MEMORY_CLASSES, peopleListSize + 1, 0);
+	free(classes);
+	if (fclose(outputFile) == EOF || !saved)
 	{
 		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
-		return EXIT_FAILURE;
+		exit(EXIT_FAILURE);
 	}
-	writeOutput(outputFile, peopleList, peopleListSize); //after this, outputFile is closed
-	freePeople(peopleList, peopleListSize);
-	return EXIT_SUCCESS;
+	return changed;
+}
+
+uint64_t hashMix(uint64_t hash, uint64_t word)
+{
+	hash ^= word * HASH_PRIME1;
+	hash = (hash << HASH_ROTATION) | (hash >> (64 - HASH_ROTATION));
+	return hash * HASH_PRIME2;
+}
+
+int hashFile(const char *path, uint64_t *const hash)
+{
+	FILE *file = fopen(path, "rb");
+	unsigned char *block = (unsigned char *) malloc(HASH_BLOCK);
+	if (file == NULL || block == NULL)
+	{
+		free(block);
+		if (file != NULL)
+		{
+			fclose(file);
+		}
+		return FAILURE;
+	}
+	*hash = CHECKSUM_BASIS;
+	uint64_t length = 0;
+	size_t got;
+	while ((got = fread(block, 1, HASH_BLOCK, file)) > 0)
+	{
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= got; i += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, block + i, sizeof(uint64_t));
+			*hash = hashMix(*hash, word);
+		}
+		for (; i < got; ++i) // only the last block of the file has a tail
+		{
+			*hash = hashMix(*hash, block[i]);
+		}
+		length += got;
+	}
+	*hash = hashMix(*hash, length);
+	int hashed = !ferror(file);
+	free(block);
+	fclose(file);
+	return hashed;
+}
+
+uint64_t paramsHash(const Config *const config)
+{
+	const float params[] = {MIN_DISTANCE, MAX_TIME, RISK_AGE, REGULAR_QUARANTINE_THRESHOLD,
+							MEDICAL_SUPERVISION_THRESHOLD, EPSILON};
+	const char *const messages[] = {OUTPUT_FILE, REGULAR_QUARANTINE_MSG,
+									MEDICAL_SUPERVISION_THRESHOLD_MSG, CLEAN_MSG};
+	uint64_t hash = CHECKSUM_BASIS;
+	for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); ++i)
+	{
+		uint32_t bits;
+		memcpy(&bits, &params[i], sizeof(uint32_t));
+		hash = hashMix(hash, bits);
+	}
+	for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); ++i)
+	{
+		for (const char *c = messages[i]; *c != '\0'; ++c)
+		{
+			hash = hashMix(hash, (unsigned char) *c);
+		}
+	}
+	// only the options that change the bytes of the output: prune mode lists the clean people by
+	// id, and a binary file is another kind of input. The pipeline, overlap and external modes
+	// (whatever their threads or budget) write the same file as the regular mode, so they share
+	// its cached output
+	const uint64_t options[] = {config->binaryMeetings, config->prune};
+	for (size_t i = 0; i < sizeof(options) / sizeof(options[0]); ++i)
+	{
+		hash = hashMix(hash, options[i]);
+	}
+	return hash;
+}
+
+char *cachedOutputPath(const char *cacheDir, const char *peoplePath, const char *meetingsPath,
+					   const Config *const config)
+{
+	uint64_t peopleHash;
+	uint64_t meetingsHash;
+	double start = traceNow();
+	if (hashFile(peoplePath, &peopleHash) == FAILURE ||
+		hashFile(meetingsPath, &meetingsHash) == FAILURE)
+	{
+		return NULL;
+	}
+	traceSpan("hash inputs", "cache", start, NO_DETAIL);
+	mkdir(cacheDir, CACHE_DIR_MODE); // it may exist already
+	int length = snprintf(NULL, 0, CACHE_FILE_FORMAT, cacheDir, 0ull, 0ull, 0ull) + 1;
+	char *path = (char *) malloc(length);
+	if (path != NULL)
+	{
+		snprintf(path, length, CACHE_FILE_FORMAT, cacheDir, (unsigned long long) peopleHash,
+				 (unsigned long long) meetingsHash, (unsigned long long) paramsHash(config));
+	}
+	return path;
+}
+
+int copyFile(FILE *from, FILE *to)
+{
+	char block[HASH_BLOCK];
+	size_t got;
+	while ((got = fread(block, 1, HASH_BLOCK, from)) > 0)
+	{
+		if (fwrite(block, 1, got, to) != got)
+		{
+			return FAILURE;
+		}
+	}
+	return !ferror(from);
+}
+
+int restoreCachedOutput(const char *cachedPath)
+{
+	FILE *cached = fopen(cachedPath, "rb");
+	if (cached == NULL) // a miss
+	{
+		return FAILURE;
+	}
+	char *tempPath = NULL;
+	FILE *outputFile = openReplacement(OUTPUT_FILE, &tempPath);
+	int copied = outputFile != NULL && copyFile(cached, outputFile);
+	statsAdd(&stats.bytesRead, fileOffset(cached));
+	statsAdd(&stats.bytesWritten, copied ? fileOffset(cached) : 0);
+	fclose(cached);
+	return replaceFile(outputFile, tempPath, OUTPUT_FILE, copied);
+}
+
+int storeCachedOutput(const char *cachedPath)
+{
+	FILE *outputFile = fopen(OUTPUT_FILE, "rb");
+	if (outputFile == NULL)
+	{
+		return FAILURE;
+	}
+	char *tempPath = NULL;
+	FILE *cached = openReplacement(cachedPath, &tempPath);
+	int copied = cached != NULL && copyFile(outputFile, cached);
+	fclose(outputFile);
+	return replaceFile(cached, tempPath, cachedPath, copied);
+}
+
+int compareExternalIds(const void *a, const void *b)
+{
+	uint64_t first = ((const ExternalPerson *) a)->id;
+	uint64_t second = ((const ExternalPerson *) b)->id;
+	return (first > second) - (first < second);
+}
+
+int compareInfectors(const void *a, const void *b)
+{
+	uint64_t first = ((const ExternalMeeting *) a)->infector;
+	uint64_t second = ((const ExternalMeeting *) b)->infector;
+	return (first > second) - (first < second);
+}
+
+int compareInfected(const void *a, const void *b)
+{
+	uint64_t first = ((const ExternalMeeting *) a)->infected;
+	uint64_t second = ((const ExternalMeeting *) b)->infected;
+	return (first > second) - (first < second);
+}
+
+int compareSequences(const void *a, const void *b)
+{
+	uint64_t first = ((const ExternalMeeting *) a)->sequence;
+	uint64_t second = ((const ExternalMeeting *) b)->sequence;
+	return (first > second) - (first < second);
+}
+
+int compareResults(const void *a, const void *b)
+{
+	return compareProbabilities(((const ExternalResult *) a)->probability,
+								((const ExternalResult *) b)->probability);
+}
+
+void mergeSortRecords(char *const records, char *const draft, size_t length, size_t recordSize,
+					  recordCompare compare)
+{
+	if (length < 2)
+	{
+		return;
+	}
+	size_t aLen = length / 2;
+	size_t bLen = length - aLen;
+	mergeSortRecords(records, draft, aLen, recordSize, compare);
+	mergeSortRecords(records + recordSize * aLen, draft, bLen, recordSize, compare);
+	memcpy(draft, records, recordSize * length);
+	const char *a = draft;
+	const char *b = draft + recordSize * aLen;
+	size_t aI = 0;
+	size_t bI = 0;
+	while (aI < aLen && bI < bLen)
+	{
+		if (compare(a + recordSize * aI, b + recordSize * bI) < 0)
+		{
+			memcpy(records + recordSize * (aI + bI), a + recordSize * aI, recordSize);
+			aI++;
+		}
+		else
+		{
+			memcpy(records + recordSize * (aI + bI), b + recordSize * bI, recordSize);
+			bI++;
+		}
+	}
+	memcpy(records + recordSize * (aI + bI), a + recordSize * aI, recordSize * (aLen - aI));
+	memcpy(records + recordSize * (aLen + bI), b + recordSize * bI, recordSize * (bLen - bI));
+}
+
+FILE *mergeRuns(FILE *a, FILE *b, size_t recordSize, recordCompare compare)
+{
+	double start = traceNow();
+	FILE *merged = tmpfile();
+	char *heads = (char *) malloc(recordSize * 2);
+	int ok = merged != NULL && heads != NULL;
+	char *aHead = heads;
+	char *bHead = heads + recordSize;
+	int hasA = ok && fread(aHead, recordSize, 1, a) == 1;
+	int hasB = ok && fread(bHead, recordSize, 1, b) == 1;
+	while (ok && (hasA || hasB))
+	{
+		// the first half's record goes first only if it's smaller, as in merge()
+		if (hasA && (!hasB || compare(aHead, bHead) < 0))
+		{
+			ok = fwrite(aHead, recordSize, 1, merged) == 1;
+			hasA = fread(aHead, recordSize, 1, a) == 1;
+		}
+		else
+		{
+			ok = fwrite(bHead, recordSize, 1, merged) == 1;
+			hasB = fread(bHead, recordSize, 1, b) == 1;
+		}
+	}
+	ok = ok && !ferror(a) && !ferror(b);
+	fclose(a);
+	fclose(b);
+	free(heads);
+	if (!ok && merged != NULL)
+	{
+		fclose(merged);
+		merged = NULL;
+	}
+	if (merged != NULL)
+	{
+		rewind(merged);
+	}
+	traceSpan("merge runs", "external", start, NO_DETAIL);
+	return merged;
+}
+
+FILE *sortRange(FILE *input, uint64_t start, uint64_t length, size_t recordSize,
+				recordCompare compare, char *const buffer, size_t capacity)
+{
+	if (length <= capacity)
+	{
+		double spillStart = traceNow();
+		FILE *run = tmpfile();
+		int ok = run != NULL && fseek(input, (long) (start * recordSize), SEEK_SET) == 0 &&
+				 fread(buffer, recordSize, length, input) == length;
+		if (ok)
+		{
+			mergeSortRecords(buffer, buffer + recordSize * capacity, length, recordSize, compare);
+			ok = fwrite(buffer, recordSize, length, run) == length;
+		}
+		if (!ok && run != NULL)
+		{
+			fclose(run);
+			run = NULL;
+		}
+		if (run != NULL)
+		{
+			rewind(run);
+		}
+		traceSpan("spill run", "external", spillStart, (long) length);
+		return run;
+	}
+	uint64_t aLen = length / 2;
+	FILE *a = sortRange(input, start, aLen, recordSize, compare, buffer, capacity);
+	FILE *b = a != NULL ? sortRange(input, start + aLen, length - aLen, recordSize, compare,
+									buffer, capacity) : NULL;
+	if (b == NULL)
+	{
+		if (a != NULL)
+		{
+			fclose(a);
+		}
+		return NULL;
+	}
+	return mergeRuns(a, b, recordSize, compare);
+}
+
+FILE *externalSort(FILE *input, size_t recordSize, recordCompare compare, size_t budget)
+{
+	if (input == NULL)
+	{
+		return NULL;
+	}
+	// the open runs' buffers and the two records of a merge come out of the budget first, and the
+	// rest holds a range and its draft
+	size_t reserved = (size_t) EXTERNAL_OPEN_RUNS * BUFSIZ + 2 * recordSize;
+	size_t capacity = budget > reserved ? (budget - reserved) / (2 * recordSize) : 0;
+	capacity = capacity < EXTERNAL_MIN_RECORDS ? EXTERNAL_MIN_RECORDS : capacity;
+	char *buffer = (char *) malloc(recordSize * capacity * 2);
+	long size = fseek(input, 0, SEEK_END) == 0 ? ftell(input) : -1;
+	FILE *sorted = NULL;
+	if (buffer != NULL && size >= 0)
+	{
+		trackMemory(MEMORY_SORT, 0, recordSize * capacity * 2);
+		sorted = sortRange(input, 0, (uint64_t) size / recordSize, recordSize, compare, buffer,
+						   capacity);
+		trackMemory(MEMORY_SORT, recordSize * capacity * 2, 0);
+	}
+	free(buffer);
+	fclose(input);
+	return sorted;
+}
+
+FILE *joinMeetings(FILE *meetings, FILE *people, int infector)
+{
+	if (meetings == NULL)
+	{
+		return NULL;
+	}
+	FILE *joined = tmpfile();
+	int ok = joined != NULL;
+	ExternalPerson person = {0, 0};
+	uint64_t peopleRead = 0; // the row of person is one less
+	ExternalMeeting meeting;
+	rewind(people);
+	while (ok && fread(&meeting, sizeof(ExternalMeeting), 1, meetings) == 1)
+	{
+		uint64_t *id = infector ? &meeting.infector : &meeting.infected;
+		while (ok && (peopleRead == 0 || person.id < *id))
+		{
+			ok = fread(&person, sizeof(ExternalPerson), 1, people) == 1;
+			++peopleRead;
+		}
+		ok = ok && person.id == *id;
+		*id = peopleRead - 1;
+		ok = ok && fwrite(&meeting, sizeof(ExternalMeeting), 1, joined) == 1;
+	}
+	ok = ok && !ferror(meetings);
+	fclose(meetings);
+	if (!ok && joined != NULL)
+	{
+		fclose(joined);
+		return NULL;
+	}
+	rewind(joined);
+	return joined;
+}
+
+RowIndex findExternalRow(FILE *people, uint64_t peopleCount, uint64_t id)
+{
+	uint64_t start = 0;
+	uint64_t end = peopleCount;
+	ExternalPerson person;
+	while (start < end)
+	{
+		uint64_t mid = start + (end - start) / 2;
+		if (fseek(people, (long) (mid * sizeof(ExternalPerson)), SEEK_SET) != 0 ||
+			fread(&person, sizeof(ExternalPerson), 1, people) != 1)
+		{
+			return NOT_FOUND;
+		}
+		if (person.id == id)
+		{
+			return (RowIndex) mid;
+		}
+		if (person.id < id)
+		{
+			start = mid + 1;
+		}
+		else
+		{
+			end = mid;
+		}
+	}
+	return NOT_FOUND;
+}
+
+FILE *spillPeople(FILE *peopleFile, uint64_t *const peopleCount)
+{
+	FILE *people = tmpfile();
+	int ok = people != NULL;
+	char line[MAX_LINE_LENGTH];
+	uint64_t offset = 0;
+	*peopleCount = 0;
+	while (ok && fgets(line, MAX_LINE_LENGTH, peopleFile))
+	{
+		size_t length = strlen(line);
+		char *rest = NULL;
+		strtok_r(line, SEPARATOR, &rest); // the name is read again when the output is written
+		char *id = strtok_r(NULL, SEPARATOR, &rest);
+		ExternalPerson person = {id != NULL ? strtoull(id, NULL, DECIMAL_BASE) : 0, offset};
+		ok = id != NULL && fwrite(&person, sizeof(ExternalPerson), 1, people) == 1;
+		offset += length;
+		++*peopleCount;
+		ok = ok && *peopleCount <= MAX_PEOPLE; // every row fits in a RowIndex
+	}
+	statsAdd(&stats.rowsParsed, *peopleCount);
+	statsAdd(&stats.bytesRead, offset);
+	if (!ok && people != NULL)
+	{
+		fclose(people);
+		return NULL;
+	}
+	return people;
+}
+
+FILE *spillMeetings(FILE *meetingsFile, FILE *people, uint64_t peopleCount,
+					float *const probabilities, uint64_t *const meetingsCount)
+{
+	FILE *meetings = tmpfile();
+	int ok = meetings != NULL;
+	char line[MAX_LINE_LENGTH];
+	*meetingsCount = 0;
+	if (ok && fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		RowIndex sickRow = findExternalRow(people, peopleCount,
+										   strtoull(line, NULL, DECIMAL_BASE));
+		ok = sickRow != NOT_FOUND;
+		if (ok)
+		{
+			probabilities[sickRow] = 1;
+		}
+		statsAdd(&stats.rowsParsed, 1);
+	}
+	while (ok && fgets(line, MAX_LINE_LENGTH, meetingsFile))
+	{
+		RawMeeting raw;
+		ok = tokenizeMeeting(line, &raw);
+		ExternalMeeting meeting = {*meetingsCount, raw.infectorId, raw.infectedId, raw.distance,
+								   raw.time};
+		ok = ok && fwrite(&meeting, sizeof(ExternalMeeting), 1, meetings) == 1;
+		++*meetingsCount;
+	}
+	statsAdd(&stats.rowsParsed, *meetingsCount);
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+	if (!ok && meetings != NULL)
+	{
+		fclose(meetings);
+		return NULL;
+	}
+	return meetings;
+}
+
+int writeExternalOutput(FILE *results, FILE *peopleFile, FILE *outputFile)
+{
+	ExternalResult block[EXTERNAL_OUTPUT_BLOCK];
+	char line[MAX_LINE_LENGTH];
+	double chunkStart = traceNow();
+	uint64_t written = 0;
+	long size = fseek(results, 0, SEEK_END) == 0 ? ftell(results) : -1;
+	if (size < 0)
+	{
+		return FAILURE;
+	}
+	// the results are sorted up, and written down from the last one, a block at a time
+	uint64_t left = (uint64_t) size / sizeof(ExternalResult);
+	while (left > 0)
+	{
+		size_t amount = left < EXTERNAL_OUTPUT_BLOCK ? (size_t) left : EXTERNAL_OUTPUT_BLOCK;
+		left -= amount;
+		if (fseek(results, (long) (left * sizeof(ExternalResult)), SEEK_SET) != 0 ||
+			fread(block, sizeof(ExternalResult), amount, results) != amount)
+		{
+			return FAILURE;
+		}
+		for (size_t i = amount; i-- > 0;)
+		{
+			char *rest = NULL;
+			if (fseek(peopleFile, (long) block[i].offset, SEEK_SET) != 0 ||
+				fgets(line, MAX_LINE_LENGTH, peopleFile) == NULL)
+			{
+				return FAILURE;
+			}
+			Person person = {strtok_r(line, SEPARATOR, &rest), block[i].id, 0,
+							 block[i].probability};
+			writePerson(outputFile, &person, block[i].probability);
+			++written;
+			if (tracer.enabled && written % TRACE_CHUNK == 0)
+			{
+				traceSpan("output chunk", "output", chunkStart, (long) (written / TRACE_CHUNK));
+				chunkStart = traceNow();
+			}
+		}
+	}
+	return SUCCESS;
+}
+
+int runExternal(const char *peoplePath, const char *meetingsPath, const char *outputPath,
+				size_t budget)
+{
+	phaseBegin(PHASE_READ_PEOPLE);
+	FILE *peopleFile = fopen(peoplePath, "r");
+	if (peopleFile == NULL)
+	{
+		fprintf(stderr, IN_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	uint64_t peopleCount;
+	FILE *people = spillPeople(peopleFile, &peopleCount);
+	if (people == NULL)
+	{
+		fprintf(stderr, peopleCount > MAX_PEOPLE ? TOO_MANY_PEOPLE_ERROR : IN_FILE_ERROR);
+		fclose(peopleFile);
+		return EXIT_FAILURE;
+	}
+	phaseEnd(PHASE_READ_PEOPLE, peopleCount);
+	phaseBegin(PHASE_SORT_BY_ID);
+	people = externalSort(people, sizeof(ExternalPerson), compareExternalIds, budget);
+	phaseEnd(PHASE_SORT_BY_ID, peopleCount);
+	phaseBegin(PHASE_READ_MEETINGS);
+	// the probabilities are the only thing kept for every person
+	float *probabilities = (float *) calloc(sizeof(float), peopleCount + 1);
+	FILE *meetingsFile = openMeetingsFile(meetingsPath, "r");
+	if (people == NULL || probabilities == NULL || meetingsFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, people == NULL ? IN_FILE_ERROR : STANDARD_LIB_ERR_MSG,
+						  NULL, 0);
+		free(probabilities);
+		fclose(peopleFile);
+		if (people != NULL)
+		{
+			fclose(people);
+		}
+		return EXIT_FAILURE;
+	}
+	trackMemory(MEMORY_PROPAGATION, 0, sizeof(float) * (peopleCount + 1));
+	uint64_t meetingsCount;
+	FILE *meetings = spillMeetings(meetingsFile, people, peopleCount, probabilities,
+								   &meetingsCount);
+	fclose(meetingsFile);
+	// every id is resolved by a merge join, and the meetings are then put back in their order
+	meetings = externalSort(meetings, sizeof(ExternalMeeting), compareInfectors, budget);
+	meetings = joinMeetings(meetings, people, SUCCESS);
+	meetings = externalSort(meetings, sizeof(ExternalMeeting), compareInfected, budget);
+	meetings = joinMeetings(meetings, people, FAILURE);
+	meetings = externalSort(meetings, sizeof(ExternalMeeting), compareSequences, budget);
+	ExternalMeeting meeting;
+	while (meetings != NULL && fread(&meeting, sizeof(ExternalMeeting), 1, meetings) == 1)
+	{
+		probabilities[meeting.infected] = probabilities[meeting.infector] *
+										  crna(meeting.distance, meeting.time);
+	}
+	int ok = meetings != NULL;
+	if (meetings != NULL)
+	{
+		fclose(meetings);
+	}
+	statsAdd(&stats.meetingsApplied, ok ? meetingsCount : 0);
+	statsAdd(&stats.lookups, ok ? 2 * meetingsCount + 1 : 0);
+	phaseEnd(PHASE_READ_MEETINGS, ok ? meetingsCount : 0);
+	phaseBegin(PHASE_SORT_BY_PROBABILITY);
+	FILE *results = ok ? tmpfile() : NULL;
+	ExternalPerson person;
+	rewind(people);
+	for (uint64_t row = 0; results != NULL && row < peopleCount; ++row)
+	{
+		ExternalResult result = {0, 0, 0, 0};
+		if (fread(&person, sizeof(ExternalPerson), 1, people) == 1)
+		{
+			result = (ExternalResult) {person.id, person.offset, probabilities[row], 0};
+		}
+		if (fwrite(&result, sizeof(ExternalResult), 1, results) != 1)
+		{
+			fclose(results);
+			results = NULL;
+		}
+	}
+	fclose(people);
+	trackMemory(MEMORY_PROPAGATION, sizeof(float) * (peopleCount + 1), 0);
+	free(probabilities);
+	results = externalSort(results, sizeof(ExternalResult), compareResults, budget);
+	phaseEnd(PHASE_SORT_BY_PROBABILITY, peopleCount);
+	phaseBegin(PHASE_WRITE_OUTPUT);
+	FILE *outputFile = results != NULL ? fopen(outputPath, "w") : NULL;
+	int written = outputFile != NULL && writeExternalOutput(results, peopleFile, outputFile);
+	if (outputFile != NULL)
+	{
+		statsAdd(&stats.bytesWritten, fileOffset(outputFile));
+		written = fclose(outputFile) != EOF && written;
+	}
+	if (results != NULL)
+	{
+		fclose(results);
+	}
+	fclose(peopleFile);
+	phaseEnd(PHASE_WRITE_OUTPUT, peopleCount);
+	if (!written)
+	{
+		fprintf(stderr, !ok ? IN_FILE_ERROR : results == NULL ? STANDARD_LIB_ERR_MSG :
+											 OUT_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+void readMeetingsFile(FILE *meetingsFile, Person *const peopleList, size_t peopleListSize)
+{
+	char line[MAX_LINE_LENGTH];
+	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) == NULL) //if file is empty, close it and return
+	{
+		if (fclose(meetingsFile) == EOF)
+		{
+			fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		}
+		return;
+	}
+	unsigned long int sickId = strtoul(line, NULL, DECIMAL_BASE);
+	RowIndex sickPersonIndex = findRow(peopleList, peopleListSize, sickId);
+	if (sickPersonIndex == NOT_FOUND)
+	{
+		beforeExitFailure(meetingsFile, IN_FILE_ERROR, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	peopleList[sickPersonIndex].probability = 1;
+	if (alerter.file != NULL)
+	{
+		alertIfCrossed(peopleList, sickPersonIndex, 0);
+	}
+	uint64_t meetings = applyMeetings(meetingsFile, peopleList, peopleListSize, 0, FAILURE);
+	statsAdd(&stats.rowsParsed, meetings + 1);
+	statsAdd(&stats.meetingsApplied, meetings);
+	statsAdd(&stats.lookups, 2 * meetings + 1);
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+	if (fclose(meetingsFile) == EOF)
+	{
+		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+uint64_t peopleChecksum(Person *const peopleList, size_t peopleListSize)
+{
+	uint64_t checksum = CHECKSUM_BASIS;
+	for (size_t i = 0; i < peopleListSize; ++i)
+	{
+		checksum ^= (uint64_t) peopleList[i].id;
+		checksum *= CHECKSUM_PRIME;
+	}
+	return checksum;
+}
+
+uint16_t quantizeFactor(float factor)
+{
+	if (!(factor > 0)) // NaN too
+	{
+		return 0;
+	}
+	if (factor >= 1)
+	{
+		return (uint16_t) COMPACT_FACTOR_SCALE;
+	}
+	return (uint16_t) (factor * COMPACT_FACTOR_SCALE + 0.5f);
+}
+
+int writeMeetingsChunk(FILE *binaryFile, const MeetingRecord *const chunk, size_t chunkSize,
+					   int compact)
+{
+	if (!compact)
+	{
+		return fwrite(chunk, sizeof(MeetingRecord), chunkSize, binaryFile) == chunkSize;
+	}
+	static CompactChunk compactChunk; // the conversion is single threaded
+	for (size_t i = 0; i < chunkSize; ++i)
+	{
+		compactChunk.rows[2 * i] = chunk[i].infectorRow;
+		compactChunk.rows[2 * i + 1] = chunk[i].infectedRow;
+		compactChunk.factors[i] = quantizeFactor(crna(chunk[i].distance, chunk[i].time));
+	}
+	return fwrite(compactChunk.rows, sizeof(RowIndex), 2 * chunkSize, binaryFile) ==
+		   2 * chunkSize &&
+		   fwrite(compactChunk.factors, sizeof(uint16_t), chunkSize, binaryFile) == chunkSize;
+}
+
+const char *convertMeetingsFile(FILE *meetingsFile, FILE *binaryFile, Person *const peopleList,
+								size_t peopleListSize, int compact)
+{
+	BinaryHeader header = {BINARY_MAGIC, compact ? BINARY_COMPACT_VERSION : BINARY_VERSION,
+						   (uint64_t) peopleListSize, peopleChecksum(peopleList, peopleListSize), 0,
+						   NO_SICK_ROW, 0};
+	MeetingRecord chunk[MEETINGS_CHUNK];
+	int chunkSize = 0;
+	char line[MAX_LINE_LENGTH];
+	const char *error = fwrite(&header, sizeof(BinaryHeader), 1, binaryFile) == 1 ? NULL :
+						OUT_FILE_ERROR;
+	// an unknown id would be written as a valid row, that binary mode can't tell apart
+	if (error == NULL && fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		unsigned long int sickId = strtoul(line, NULL, DECIMAL_BASE);
+		header.sickRow = findRow(peopleList, peopleListSize, sickId);
+		error = header.sickRow != NOT_FOUND ? NULL : IN_FILE_ERROR;
+		while (error == NULL && fgets(line, MAX_LINE_LENGTH, meetingsFile))
+		{
+			if (parseMeeting(peopleList, peopleListSize, line, &chunk[chunkSize]) == FAILURE)
+			{
+				error = IN_FILE_ERROR;
+				break;
+			}
+			++chunkSize;
+			++header.meetingsCount;
+			if (chunkSize == MEETINGS_CHUNK)
+			{
+				error = writeMeetingsChunk(binaryFile, chunk, chunkSize, compact) ? NULL :
+						OUT_FILE_ERROR;
+				chunkSize = 0;
+			}
+		}
+	}
+	if (error == NULL && chunkSize > 0)
+	{
+		error = writeMeetingsChunk(binaryFile, chunk, chunkSize, compact) ? NULL : OUT_FILE_ERROR;
+	}
+	statsAdd(&stats.rowsParsed, header.meetingsCount + 1);
+	statsAdd(&stats.lookups, 2 * header.meetingsCount + 1);
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+	statsAdd(&stats.bytesWritten, fileOffset(binaryFile));
+	// the header is written again, now that the sick row and the meetings' count are known
+	if (error == NULL && (fseek(binaryFile, 0, SEEK_SET) != 0 ||
+						  fwrite(&header, sizeof(BinaryHeader), 1, binaryFile) != 1))
+	{
+		error = OUT_FILE_ERROR;
+	}
+	if (fclose(meetingsFile) == EOF && error == NULL)
+	{
+		error = STANDARD_LIB_ERR_MSG;
+	}
+	return error;
+}
+
+uint64_t applyRecords(FILE *binaryFile, Person *const peopleList, size_t peopleListSize)
+{
+	MeetingRecord chunk[MEETINGS_CHUNK];
+	uint64_t meetingsRead = 0;
+	size_t chunkSize;
+	double chunkStart = traceNow();
+	while ((chunkSize = fread(chunk, sizeof(MeetingRecord), MEETINGS_CHUNK, binaryFile)) > 0)
+	{
+		for (size_t i = 0; i < chunkSize; ++i)
+		{
+			if (chunk[i].infectorRow >= peopleListSize || chunk[i].infectedRow >= peopleListSize)
+			{
+				beforeExitFailure(binaryFile, IN_FILE_ERROR, peopleList, peopleListSize);
+				exit(EXIT_FAILURE);
+			}
+			float prob = crna(chunk[i].distance, chunk[i].time);
+			peopleList[chunk[i].infectedRow].probability =
+					peopleList[chunk[i].infectorRow].probability * prob;
+		}
+		meetingsRead += chunkSize;
+		traceSpan("binary chunk", "meetings", chunkStart, (long) (meetingsRead / MEETINGS_CHUNK));
+		chunkStart = traceNow();
+	}
+	return meetingsRead;
+}
+
+uint64_t applyCompactChunks(FILE *binaryFile, uint64_t meetingsCount, Person *const peopleList,
+							size_t peopleListSize)
+{
+	static CompactChunk chunk; // a binary file is read by a single thread
+	uint64_t meetingsRead = 0;
+	double chunkStart = traceNow();
+	while (meetingsRead < meetingsCount)
+	{
+		uint64_t left = meetingsCount - meetingsRead;
+		size_t chunkSize = left < MEETINGS_CHUNK ? (size_t) left : MEETINGS_CHUNK;
+		if (fread(chunk.rows, sizeof(RowIndex), 2 * chunkSize, binaryFile) != 2 * chunkSize ||
+			fread(chunk.factors, sizeof(uint16_t), chunkSize, binaryFile) != chunkSize)
+		{
+			break;
+		}
+		for (size_t i = 0; i < chunkSize; ++i)
+		{
+			RowIndex infectorRow = chunk.rows[2 * i];
+			RowIndex infectedRow = chunk.rows[2 * i + 1];
+			if (infectorRow >= peopleListSize || infectedRow >= peopleListSize)
+			{
+				beforeExitFailure(binaryFile, IN_FILE_ERROR, peopleList, peopleListSize);
+				exit(EXIT_FAILURE);
+			}
+			peopleList[infectedRow].probability =
+					peopleList[infectorRow].probability * (chunk.factors[i] * COMPACT_FACTOR_STEP);
+		}
+		meetingsRead += chunkSize;
+		traceSpan("compact chunk", "meetings", chunkStart, (long) (meetingsRead / MEETINGS_CHUNK));
+		chunkStart = traceNow();
+	}
+	return meetingsRead;
+}
+
+void readBinaryMeetingsFile(FILE *binaryFile, Person *const peopleList, size_t peopleListSize)
+{
+	BinaryHeader header;
+	if (fread(&header, sizeof(BinaryHeader), 1, binaryFile) != 1 || header.magic != BINARY_MAGIC ||
+		(header.version != BINARY_VERSION && header.version != BINARY_COMPACT_VERSION) ||
+		header.peopleCount != (uint64_t) peopleListSize ||
+		header.peopleChecksum != peopleChecksum(peopleList, peopleListSize))
+	{
+		beforeExitFailure(binaryFile, IN_FILE_ERROR, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	if (header.sickRow != NO_SICK_ROW)
+	{
+		if (header.sickRow >= peopleListSize)
+		{
+			beforeExitFailure(binaryFile, IN_FILE_ERROR, peopleList, peopleListSize);
+			exit(EXIT_FAILURE);
+		}
+		peopleList[header.sickRow].probability = 1;
+	}
+	uint64_t meetingsRead = header.version == BINARY_COMPACT_VERSION ?
+							applyCompactChunks(binaryFile, header.meetingsCount, peopleList,
+											   peopleListSize) :
+							applyRecords(binaryFile, peopleList, peopleListSize);
+	statsAdd(&stats.meetingsApplied, meetingsRead);
+	statsAdd(&stats.bytesRead, fileOffset(binaryFile));
+	// the compact chunks are read by the count, so anything after the last one isn't of the format
+	if (ferror(binaryFile) || meetingsRead != header.meetingsCount ||
+		(header.version == BINARY_COMPACT_VERSION && fgetc(binaryFile) != EOF))
+	{
+		beforeExitFailure(binaryFile, IN_FILE_ERROR, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	if (fclose(binaryFile) == EOF)
+	{
+		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+Classification classify(float probability)
+{
+	if (probability >= MEDICAL_SUPERVISION_THRESHOLD ||
+		fabsf(probability - MEDICAL_SUPERVISION_THRESHOLD) < EPSILON)
+	{
+		return HOSPITALIZATION;
+	}
+	if (probability >= REGULAR_QUARANTINE_THRESHOLD ||
+		fabsf(probability - REGULAR_QUARANTINE_THRESHOLD) < EPSILON)
+	{
+		return QUARANTINE;
+	}
+	return CLEAN;
+}
+
+void writePerson(FILE *outputFile, const Person *const person, float probability)
+{
+	switch (classify(probability))
+	{
+		case HOSPITALIZATION:
+			fprintf(outputFile, MEDICAL_SUPERVISION_THRESHOLD_MSG, person->name, person->id);
+			break;
+		case QUARANTINE:
+			fprintf(outputFile, REGULAR_QUARANTINE_MSG, person->name, person->id);
+			break;
+		default:
+			fprintf(outputFile, CLEAN_MSG, person->name, person->id);
+			break;
+	}
+}
+
+void writePeople(FILE *outputFile, Person *const peopleList, size_t peopleListSize)
+{
+	double chunkStart = traceNow();
+	for (size_t i = peopleListSize; i-- > 0;)
+	{
+		writePerson(outputFile, &peopleList[i], peopleList[i].probability);
+		if (tracer.enabled && i % TRACE_CHUNK == 0)
+		{
+			traceSpan("output chunk", "output", chunkStart,
+					  (long) ((peopleListSize - i) / TRACE_CHUNK));
+			chunkStart = traceNow();
+		}
+	}
+}
+
+void writeOutput(FILE *outputFile, Person *const peopleList, size_t peopleListSize)
+{
+	writePeople(outputFile, peopleList, peopleListSize);
+	statsAdd(&stats.bytesWritten, fileOffset(outputFile));
+	if (fclose(outputFile) == EOF)
+	{
+		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+RowIndex findRow(Person *const peopleList, size_t peopleListSize, unsigned long int idToFind)
+{
+	size_t start = 0;
+	size_t end = peopleListSize;
+	while (start < end)
+	{
+		size_t mid = start + ((end - start) / 2);
+		if (peopleList[mid].id < idToFind)
+		{
+			start = mid + 1;
+		}
+		else
+		{
+			end = mid;
+		}
+	}
+	if (start < peopleListSize && peopleList[start].id == idToFind)
+	{
+		return (RowIndex) start;
+	}
+	return NOT_FOUND;
+}
+
+int resolveMeeting(Person *const peopleList, size_t peopleListSize, char *line,
+				   MeetingRecord *const meeting)
+{
+	char *rest = NULL;
+	char *fields[4] = {strtok_r(line, SEPARATOR LINE_END, &rest), NULL, NULL, NULL};
+	for (int i = 1; i < 4 && fields[i - 1] != NULL; ++i)
+	{
+		fields[i] = strtok_r(NULL, SEPARATOR LINE_END, &rest);
+	}
+	if (fields[3] == NULL)
+	{
+		return FAILURE;
+	}
+	RowIndex infectorRow = findRow(peopleList, peopleListSize,
+								   strtoul(fields[0], NULL, DECIMAL_BASE));
+	RowIndex infectedRow = findRow(peopleList, peopleListSize,
+								   strtoul(fields[1], NULL, DECIMAL_BASE));
+	if (infectorRow == NOT_FOUND || infectedRow == NOT_FOUND)
+	{
+		return FAILURE;
+	}
+	meeting->infectorRow = infectorRow;
+	meeting->infectedRow = infectedRow;
+	meeting->distance = strtof(fields[2], NULL);
+	meeting->time = strtof(fields[3], NULL);
+	return SUCCESS;
+}
+
+int touchRow(Investigation *const investigation, Person *const peopleList, RowIndex row,
+			 float probability)
+{
+	if (!investigation->marks[row])
+	{
+		if (investigation->touchedCount == investigation->touchedCapacity)
+		{
+			size_t capacity = investigation->touchedCapacity * ALLOC_SIZE;
+			RowIndex *temp = (RowIndex *) realloc(investigation->touched,
+												  sizeof(RowIndex) * capacity);
+			if (temp == NULL)
+			{
+				return FAILURE;
+			}
+			trackMemory(MEMORY_INDEX, sizeof(RowIndex) * investigation->touchedCapacity,
+						sizeof(RowIndex) * capacity);
+			investigation->touched = temp;
+			investigation->touchedCapacity = capacity;
+		}
+		investigation->touched[investigation->touchedCount] = row;
+		++investigation->touchedCount;
+		investigation->marks[row] = SUCCESS;
+	}
+	peopleList[row].probability = probability;
+	return SUCCESS;
+}
+
+const char *investigate(FILE *meetings, Investigation *const investigation,
+						Person *const peopleList, size_t peopleListSize)
+{
+	char line[MAX_LINE_LENGTH];
+	if (fgets(line, MAX_LINE_LENGTH, meetings) == NULL ||
+		strncmp(line, REQUEST_END, strlen(REQUEST_END)) == 0)
+	{
+		return NULL; // no sick person, nobody is touched
+	}
+	RowIndex sickRow = findRow(peopleList, peopleListSize, strtoul(line, NULL, DECIMAL_BASE));
+	if (sickRow == NOT_FOUND)
+	{
+		return "unknown sick id";
+	}
+	if (touchRow(investigation, peopleList, sickRow, 1) == FAILURE)
+	{
+		return "out of memory";
+	}
+	while (fgets(line, MAX_LINE_LENGTH, meetings) &&
+		   strncmp(line, REQUEST_END, strlen(REQUEST_END)) != 0)
+	{
+		MeetingRecord meeting;
+		if (resolveMeeting(peopleList, peopleListSize, line, &meeting) == FAILURE)
+		{
+			return "malformed meeting or unknown id";
+		}
+		float prob = crna(meeting.distance, meeting.time);
+		prob = peopleList[meeting.infectorRow].probability * prob;
+		if (touchRow(investigation, peopleList, meeting.infectedRow, prob) == FAILURE)
+		{
+			return "out of memory";
+		}
+	}
+	return NULL;
+}
+
+const char *respond(FILE *response, Investigation *const investigation, Person *const peopleList)
+{
+	const char *error = NULL;
+	size_t count = investigation->touchedCount;
+	if (response != NULL)
+	{
+		Person *touched = (Person *) calloc(sizeof(Person), count + 1);
+		Person *draft = (Person *) calloc(sizeof(Person), count + 1);
+		if (touched == NULL || draft == NULL)
+		{
+			error = "out of memory";
+		}
+		else
+		{
+			trackMemory(MEMORY_SORT, 0, ALLOC_SIZE * sizeof(Person) * (count + 1));
+			for (size_t i = 0; i < count; ++i)
+			{
+				touched[i] = peopleList[investigation->touched[i]];
+			}
+			// sorted by id first, so the ties are in the same order as in the output file
+			mergeSortById(touched, draft, count, 0);
+			mergeSort(touched, draft, count, 0, probCompare);
+			writePeople(response, touched, count);
+			trackMemory(MEMORY_SORT, ALLOC_SIZE * sizeof(Person) * (count + 1), 0);
+		}
+		free(touched);
+		free(draft);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		peopleList[investigation->touched[i]].probability = 0;
+		investigation->marks[investigation->touched[i]] = FAILURE;
+	}
+	investigation->touchedCount = 0;
+	return error;
+}
+
+void handleRequest(int clientFd, Investigation *const investigation, Person *const peopleList,
+				   size_t peopleListSize)
+{
+	struct timeval timeout = {REQUEST_TIMEOUT_SECONDS, 0};
+	int timed = setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+				setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0;
+	int responseFd = timed ? dup(clientFd) : -1;
+	FILE *request = fdopen(clientFd, "r");
+	FILE *response = responseFd == -1 ? NULL : fdopen(responseFd, "w");
+	if (request == NULL || response == NULL)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		request == NULL ? close(clientFd) : fclose(request);
+		if (response != NULL)
+		{
+			fclose(response);
+		}
+		else if (responseFd != -1)
+		{
+			close(responseFd);
+		}
+		return;
+	}
+	char line[MAX_LINE_LENGTH];
+	const char *error = NULL;
+	if (fgets(line, MAX_LINE_LENGTH, request) == NULL)
+	{
+		error = "empty request";
+	}
+	else if (strncmp(line, REQUEST_FILE, strlen(REQUEST_FILE)) == 0)
+	{
+		line[strcspn(line, LINE_END)] = '\0';
+		FILE *meetingsFile = fopen(line + strlen(REQUEST_FILE), "r");
+		if (meetingsFile == NULL)
+		{
+			error = "can't open the meetings' file";
+		}
+		else
+		{
+			error = investigate(meetingsFile, investigation, peopleList, peopleListSize);
+			fclose(meetingsFile);
+		}
+	}
+	else if (strncmp(line, REQUEST_INLINE, strlen(REQUEST_INLINE)) == 0)
+	{
+		error = investigate(request, investigation, peopleList, peopleListSize);
+		if (error == NULL && ferror(request))
+		{
+			error = "the request timed out"; // the meetings read so far aren't the whole request
+		}
+	}
+	else
+	{
+		error = "unknown request";
+	}
+	// respond() is called even if the investigation failed, so the rows are always reset
+	const char *respondError = respond(error == NULL ? response : NULL, investigation, peopleList);
+	if (error != NULL || respondError != NULL)
+	{
+		fprintf(response, REQUEST_ERROR, error != NULL ? error : respondError);
+	}
+	fclose(request);
+	fclose(response);
+}
+
+int removeSocket(const char *socketPath)
+{
+	struct stat status;
+	if (lstat(socketPath, &status) == -1)
+	{
+		return errno == ENOENT;
+	}
+	return S_ISSOCK(status.st_mode) && unlink(socketPath) == 0;
+}
+
+void stopServer(int signum)
+{
+	(void) signum;
+	serverStopped = SUCCESS;
+}
+
+int serve(const char *socketPath, Person *const peopleList, size_t peopleListSize)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	strcpy(address.sun_path, socketPath);
+	if (!removeSocket(socketPath)) // never remove a file that isn't a socket
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	Investigation investigation;
+	investigation.touched = (RowIndex *) malloc(sizeof(RowIndex) * ALLOC_SIZE);
+	investigation.touchedCount = 0;
+	investigation.touchedCapacity = ALLOC_SIZE;
+	investigation.marks = (unsigned char *) calloc(sizeof(unsigned char), peopleListSize + 1);
+	int serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (investigation.touched == NULL || investigation.marks == NULL || serverFd == -1 ||
+		bind(serverFd, (struct sockaddr *) &address, sizeof(address)) == -1 ||
+		listen(serverFd, LISTEN_BACKLOG) == -1)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		free(investigation.touched);
+		free(investigation.marks);
+		if (serverFd != -1)
+		{
+			close(serverFd);
+		}
+		return EXIT_FAILURE;
+	}
+	trackMemory(MEMORY_INDEX, 0, sizeof(RowIndex) * ALLOC_SIZE + peopleListSize + 1);
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = stopServer; // no SA_RESTART, so accept() is interrupted
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN); // a client that disconnects mustn't kill the server
+	while (!serverStopped)
+	{
+		int clientFd = accept(serverFd, NULL, NULL);
+		if (clientFd == -1)
+		{
+			if (errno != EINTR)
+			{
+				fprintf(stderr, STANDARD_LIB_ERR_MSG);
+			}
+			continue;
+		}
+		double requestStart = traceNow();
+		handleRequest(clientFd, &investigation, peopleList, peopleListSize);
+		traceSpan("request", "server", requestStart, NO_DETAIL);
+	}
+	close(serverFd);
+	removeSocket(socketPath);
+	trackMemory(MEMORY_INDEX, sizeof(RowIndex) * investigation.touchedCapacity + peopleListSize + 1,
+				0);
+	free(investigation.touched);
+	free(investigation.marks);
+	return EXIT_SUCCESS;
+}
+
+const char *writeRowsOutput(const char *outputPath, Person *const peopleList, size_t peopleListSize,
+							const float *const probabilities, RowIndex *const rows,
+							RowIndex *const draftRows)
+{
+	for (size_t i = 0; i < peopleListSize; ++i)
+	{
+		rows[i] = (RowIndex) i; // sorted by id, as the people's array is in sortByProbability()
+	}
+	mergeSortRows(rows, draftRows, peopleListSize, 0, probabilities);
+	FILE *outputFile = fopen(outputPath, "w");
+	if (outputFile == NULL)
+	{
+		return OUT_FILE_ERROR;
+	}
+	for (size_t i = peopleListSize; i-- > 0;)
+	{
+		writePerson(outputFile, &peopleList[rows[i]], probabilities[rows[i]]);
+	}
+	statsAdd(&stats.bytesWritten, fileOffset(outputFile));
+	if (fclose(outputFile) == EOF)
+	{
+		return STANDARD_LIB_ERR_MSG;
+	}
+	return NULL;
+}
+
+int runBatchJob(BatchPool *const pool, int job)
+{
+	size_t size = pool->peopleListSize;
+	FILE *meetingsFile = fopen(pool->meetingsPaths[job], "r");
+	if (meetingsFile == NULL)
+	{
+		fprintf(stderr, IN_FILE_ERROR);
+		return FAILURE;
+	}
+	float *probabilities = (float *) calloc(sizeof(float), size + 1);
+	RowIndex *rows = (RowIndex *) malloc(sizeof(RowIndex) * (size + 1));
+	RowIndex *draftRows = (RowIndex *) malloc(sizeof(RowIndex) * (size + 1));
+	int success = probabilities != NULL && rows != NULL && draftRows != NULL;
+	const char *error = success ? NULL : STANDARD_LIB_ERR_MSG;
+	uint64_t jobBytes = success ? (sizeof(float) + ALLOC_SIZE * sizeof(RowIndex)) * (size + 1) : 0;
+	trackMemory(MEMORY_PROPAGATION, 0, jobBytes);
+	char line[MAX_LINE_LENGTH];
+	uint64_t meetings = 0;
+	double spanStart = traceNow();
+	if (success && fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		RowIndex sickRow = findRow(pool->peopleList, size, strtoul(line, NULL, DECIMAL_BASE));
+		if (sickRow == NOT_FOUND)
+		{
+			error = IN_FILE_ERROR;
+		}
+		else
+		{
+			probabilities[sickRow] = 1;
+		}
+		while (error == NULL && fgets(line, MAX_LINE_LENGTH, meetingsFile))
+		{
+			MeetingRecord meeting;
+			if (resolveMeeting(pool->peopleList, size, line, &meeting) == FAILURE)
+			{
+				error = IN_FILE_ERROR;
+				break;
+			}
+			float prob = crna(meeting.distance, meeting.time);
+			probabilities[meeting.infectedRow] = probabilities[meeting.infectorRow] * prob;
+			++meetings;
+		}
+	}
+	traceSpan("propagate", "batch", spanStart, job + 1);
+	statsAdd(&stats.rowsParsed, meetings + 1);
+	statsAdd(&stats.meetingsApplied, meetings);
+	statsAdd(&stats.lookups, 2 * meetings + 1);
+	statsAdd(&stats.allocations, 3);
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+	if (fclose(meetingsFile) == EOF && error == NULL)
+	{
+		error = STANDARD_LIB_ERR_MSG;
+	}
+	if (error == NULL)
+	{
+		char outputPath[BATCH_OUTPUT_LENGTH];
+		snprintf(outputPath, BATCH_OUTPUT_LENGTH, BATCH_OUTPUT_FILE, job + 1);
+		spanStart = traceNow();
+		error = writeRowsOutput(outputPath, pool->peopleList, size, probabilities, rows, draftRows);
+		traceSpan("sort and write", "batch", spanStart, job + 1);
+	}
+	trackMemory(MEMORY_PROPAGATION, jobBytes, 0);
+	free(probabilities);
+	free(rows);
+	free(draftRows);
+	if (error != NULL)
+	{
+		fprintf(stderr, "%s", error);
+		return FAILURE;
+	}
+	return SUCCESS;
+}
+
+void *batchWorker(void *pool)
+{
+	BatchPool *batchPool = (BatchPool *) pool;
+	while (1)
+	{
+		pthread_mutex_lock(&batchPool->lock);
+		int job = batchPool->nextJob;
+		++batchPool->nextJob;
+		pthread_mutex_unlock(&batchPool->lock);
+		if (job >= batchPool->jobsAmount)
+		{
+			return NULL;
+		}
+		double jobStart = traceNow();
+		if (runBatchJob(batchPool, job) == FAILURE)
+		{
+			pthread_mutex_lock(&batchPool->lock);
+			++batchPool->failures;
+			pthread_mutex_unlock(&batchPool->lock);
+		}
+		traceSpan("batch job", "batch", jobStart, job + 1);
+	}
+}
+
+int runBatch(Person *const peopleList, size_t peopleListSize, char **meetingsPaths, int jobsAmount,
+			 int threads)
+{
+	if (threads <= 0)
+	{
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = processors > 0 ? (int) processors : 1;
+	}
+	if (threads > jobsAmount)
+	{
+		threads = jobsAmount;
+	}
+	BatchPool pool = {peopleList, peopleListSize, meetingsPaths, jobsAmount, 0, 0,
+					  PTHREAD_MUTEX_INITIALIZER};
+	pthread_t *workers = (pthread_t *) malloc(sizeof(pthread_t) * threads);
+	if (workers == NULL)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		return EXIT_FAILURE;
+	}
+	int started = 0;
+	for (; started < threads; ++started)
+	{
+		if (pthread_create(&workers[started], NULL, batchWorker, &pool) != 0)
+		{
+			break;
+		}
+	}
+	if (started == 0) // no threads at all, the jobs run on this thread
+	{
+		batchWorker(&pool);
+	}
+	for (int i = 0; i < started; ++i)
+	{
+		pthread_join(workers[i], NULL);
+	}
+	free(workers);
+	pthread_mutex_destroy(&pool.lock);
+	return pool.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void applyMultiSourceMeeting(const MeetingRecord *const meeting, float *const lanes,
+							 uint64_t *const masks, int sourcesAmount)
+{
+	uint64_t mask = masks[meeting->infectorRow];
+	float *infected = &lanes[(size_t) meeting->infectedRow * sourcesAmount];
+	if (mask == 0) // nobody reached the infector, so the infected isn't reached either
+	{
+		if (masks[meeting->infectedRow] != 0)
+		{
+			memset(infected, 0, sizeof(float) * sourcesAmount);
+			masks[meeting->infectedRow] = 0;
+		}
+		return;
+	}
+	const float *infector = &lanes[(size_t) meeting->infectorRow * sourcesAmount];
+	float prob = crna(meeting->distance, meeting->time);
+	for (int lane = 0; lane < sourcesAmount; ++lane)
+	{
+		infected[lane] = infector[lane] * prob;
+	}
+	masks[meeting->infectedRow] = prob != 0 ? mask : 0;
+}
+
+int runMultiSource(FILE *meetingsFile, Person *const peopleList, size_t peopleListSize)
+{
+	char line[SOURCES_LINE_LENGTH];
+	RowIndex sources[MAX_SOURCES];
+	int sourcesAmount = 0;
+	const char *error = NULL;
+	if (fgets(line, SOURCES_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		char *rest = NULL;
+		for (char *id = strtok_r(line, SEPARATOR LINE_END, &rest); id != NULL && error == NULL;
+			 id = strtok_r(NULL, SEPARATOR LINE_END, &rest))
+		{
+			RowIndex row = findRow(peopleList, peopleListSize, strtoul(id, NULL, DECIMAL_BASE));
+			if (row == NOT_FOUND || sourcesAmount == MAX_SOURCES)
+			{
+				error = IN_FILE_ERROR;
+			}
+			else
+			{
+				sources[sourcesAmount] = row;
+				++sourcesAmount;
+			}
+		}
+	}
+	if (error == NULL && sourcesAmount == 0) // no sick people, no outputs
+	{
+		error = fclose(meetingsFile) == EOF ? STANDARD_LIB_ERR_MSG : NULL;
+		meetingsFile = NULL;
+	}
+	float *lanes = NULL;
+	uint64_t *masks = NULL;
+	uint64_t lanesBytes = 0;
+	uint64_t masksBytes = 0;
+	if (error == NULL && meetingsFile != NULL)
+	{
+		lanes = (float *) calloc(sizeof(float), (size_t) peopleListSize * sourcesAmount + 1);
+		masks = (uint64_t *) calloc(sizeof(uint64_t), peopleListSize + 1);
+		if (lanes == NULL || masks == NULL)
+		{
+			error = STANDARD_LIB_ERR_MSG;
+		}
+		else
+		{
+			lanesBytes = sizeof(float) * ((uint64_t) peopleListSize * sourcesAmount + 1);
+			masksBytes = sizeof(uint64_t) * (peopleListSize + 1);
+			trackMemory(MEMORY_PROPAGATION, 0, lanesBytes + masksBytes);
+		}
+	}
+	if (error == NULL && meetingsFile != NULL)
+	{
+		for (int lane = 0; lane < sourcesAmount; ++lane)
+		{
+			lanes[(size_t) sources[lane] * sourcesAmount + lane] = 1;
+			masks[sources[lane]] |= (uint64_t) 1 << lane;
+		}
+		uint64_t meetings = 0;
+		while (error == NULL && fgets(line, MAX_LINE_LENGTH, meetingsFile))
+		{
+			MeetingRecord meeting;
+			if (resolveMeeting(peopleList, peopleListSize, line, &meeting) == FAILURE)
+			{
+				error = IN_FILE_ERROR;
+			}
+			else
+			{
+				applyMultiSourceMeeting(&meeting, lanes, masks, sourcesAmount);
+				++meetings;
+			}
+		}
+		statsAdd(&stats.rowsParsed, meetings + 1);
+		statsAdd(&stats.meetingsApplied, meetings);
+		statsAdd(&stats.lookups, 2 * meetings + sourcesAmount);
+		statsAdd(&stats.allocations, 2);
+		statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+		phaseEnd(PHASE_READ_MEETINGS, meetings);
+		phaseBegin(PHASE_WRITE_OUTPUT);
+	}
+	if (meetingsFile != NULL && fclose(meetingsFile) == EOF && error == NULL)
+	{
+		error = STANDARD_LIB_ERR_MSG;
+	}
+	trackMemory(MEMORY_PROPAGATION, masksBytes, 0);
+	free(masks);
+	float *probabilities = NULL;
+	RowIndex *rows = NULL;
+	RowIndex *draftRows = NULL;
+	uint64_t outputBytes = 0;
+	if (error == NULL && lanes != NULL)
+	{
+		probabilities = (float *) malloc(sizeof(float) * (peopleListSize + 1));
+		rows = (RowIndex *) malloc(sizeof(RowIndex) * (peopleListSize + 1));
+		draftRows = (RowIndex *) malloc(sizeof(RowIndex) * (peopleListSize + 1));
+		if (probabilities == NULL || rows == NULL || draftRows == NULL)
+		{
+			error = STANDARD_LIB_ERR_MSG;
+		}
+		else
+		{
+			outputBytes = (sizeof(float) + ALLOC_SIZE * sizeof(RowIndex)) * (peopleListSize + 1);
+			trackMemory(MEMORY_PROPAGATION, 0, outputBytes);
+		}
+	}
+	for (int lane = 0; error == NULL && lanes != NULL && lane < sourcesAmount; ++lane)
+	{
+		for (size_t i = 0; i < peopleListSize; ++i)
+		{
+			probabilities[i] = lanes[i * sourcesAmount + lane];
+		}
+		char outputPath[BATCH_OUTPUT_LENGTH];
+		snprintf(outputPath, BATCH_OUTPUT_LENGTH, BATCH_OUTPUT_FILE, lane + 1);
+		error = writeRowsOutput(outputPath, peopleList, peopleListSize, probabilities, rows,
+								draftRows);
+	}
+	if (probabilities != NULL)
+	{
+		statsAdd(&stats.allocations, 3);
+		phaseEnd(PHASE_WRITE_OUTPUT, (uint64_t) peopleListSize * sourcesAmount);
+	}
+	trackMemory(MEMORY_PROPAGATION, lanesBytes + outputBytes, 0);
+	free(lanes);
+	free(probabilities);
+	free(rows);
+	free(draftRows);
+	if (error != NULL)
+	{
+		fprintf(stderr, "%s", error);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+size_t liveSlot(const LiveSet *const live, unsigned long int id)
+{
+	size_t mask = live->capacity - 1;
+	size_t slot = (size_t) (((uint64_t) id * HASH_MULTIPLIER) >> 32) & mask;
+	while (live->rows[slot] != NO_ROW && live->ids[slot] != id)
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+int liveInsert(LiveSet *const live, unsigned long int id, RowIndex row)
+{
+	if ((live->count + 1) * ALLOC_SIZE > live->capacity) // keep it at most half full
+	{
+		LiveSet grown = {NULL, NULL, live->capacity * ALLOC_SIZE, 0};
+		grown.ids = (unsigned long int *) malloc(sizeof(unsigned long int) * grown.capacity);
+		grown.rows = (RowIndex *) malloc(sizeof(RowIndex) * grown.capacity);
+		if (grown.ids == NULL || grown.rows == NULL)
+		{
+			free(grown.ids);
+			free(grown.rows);
+			return FAILURE;
+		}
+		memset(grown.rows, 0xFF, sizeof(RowIndex) * grown.capacity); // all NO_ROW
+		for (size_t i = 0; i < live->capacity; ++i)
+		{
+			if (live->rows[i] != NO_ROW)
+			{
+				size_t slot = liveSlot(&grown, live->ids[i]);
+				grown.ids[slot] = live->ids[i];
+				grown.rows[slot] = live->rows[i];
+			}
+		}
+		grown.count = live->count;
+		trackMemory(MEMORY_INDEX, (sizeof(unsigned long int) + sizeof(RowIndex)) * live->capacity,
+					(sizeof(unsigned long int) + sizeof(RowIndex)) * grown.capacity);
+		free(live->ids);
+		free(live->rows);
+		*live = grown;
+	}
+	size_t slot = liveSlot(live, id);
+	if (live->rows[slot] == NO_ROW)
+	{
+		++live->count;
+	}
+	live->ids[slot] = id;
+	live->rows[slot] = row;
+	return SUCCESS;
+}
+
+void liveRemove(LiveSet *const live, unsigned long int id)
+{
+	size_t mask = live->capacity - 1;
+	size_t slot = liveSlot(live, id);
+	if (live->rows[slot] == NO_ROW)
+	{
+		return;
+	}
+	live->rows[slot] = NO_ROW;
+	--live->count;
+	// the following entries of the same probe sequence are moved back, so no lookup stops early
+	for (size_t next = (slot + 1) & mask; live->rows[next] != NO_ROW; next = (next + 1) & mask)
+	{
+		size_t home = (size_t) (((uint64_t) live->ids[next] * HASH_MULTIPLIER) >> 32) & mask;
+		if (((next - home) & mask) >= ((next - slot) & mask))
+		{
+			live->ids[slot] = live->ids[next];
+			live->rows[slot] = live->rows[next];
+			live->rows[next] = NO_ROW;
+			slot = next;
+		}
+	}
+}
+
+void readMeetingsFilePruned(FILE *meetingsFile, Person *const peopleList, size_t peopleListSize)
+{
+	char line[MAX_LINE_LENGTH];
+	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) == NULL) //if file is empty, close it and return
+	{
+		if (fclose(meetingsFile) == EOF)
+		{
+			fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		}
+		return;
+	}
+	LiveSet live;
+	live.ids = (unsigned long int *) malloc(sizeof(unsigned long int) * LIVE_SET_CAPACITY);
+	live.rows = (RowIndex *) malloc(sizeof(RowIndex) * LIVE_SET_CAPACITY);
+	live.capacity = LIVE_SET_CAPACITY;
+	live.count = 0;
+	int success = live.ids != NULL && live.rows != NULL;
+	const char *error = STANDARD_LIB_ERR_MSG;
+	if (success)
+	{
+		trackMemory(MEMORY_INDEX, 0,
+					(sizeof(unsigned long int) + sizeof(RowIndex)) * LIVE_SET_CAPACITY);
+		memset(live.rows, 0xFF, sizeof(RowIndex) * LIVE_SET_CAPACITY); // all NO_ROW
+		statsAdd(&stats.lookups, 1);
+		unsigned long int sickId = strtoul(line, NULL, DECIMAL_BASE);
+		RowIndex sickPersonIndex = findRow(peopleList, peopleListSize, sickId);
+		if (sickPersonIndex == NOT_FOUND)
+		{
+			error = IN_FILE_ERROR;
+			success = FAILURE;
+		}
+		else
+		{
+			peopleList[sickPersonIndex].probability = 1;
+			success = liveInsert(&live, sickId, sickPersonIndex);
+		}
+	}
+	uint64_t meetings = 0;
+	uint64_t searches = 0;
+	while (success && fgets(line, MAX_LINE_LENGTH, meetingsFile))
+	{
+		++meetings;
+		char *rest = NULL;
+		unsigned long int infectorId = strtoul(strtok_r(line, SEPARATOR, &rest), NULL,
+											   DECIMAL_BASE);
+		unsigned long int infectedId = strtoul(strtok_r(NULL, SEPARATOR, &rest), NULL,
+											   DECIMAL_BASE);
+		size_t infectorSlot = liveSlot(&live, infectorId);
+		size_t infectedSlot = liveSlot(&live, infectedId);
+		RowIndex infectedRow = live.rows[infectedSlot];
+		if (live.rows[infectorSlot] == NO_ROW) // the infected can't reach a threshold either
+		{
+			if (infectedRow != NO_ROW)
+			{
+				peopleList[infectedRow].probability = 0;
+				liveRemove(&live, infectedId);
+			}
+			continue;
+		}
+		if (infectedRow == NO_ROW)
+		{
+			infectedRow = findRow(peopleList, peopleListSize, infectedId);
+			++searches;
+			if (infectedRow == NOT_FOUND)
+			{
+				error = IN_FILE_ERROR;
+				success = FAILURE;
+				break;
+			}
+		}
+		float distance = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+		float time = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+		float prob = crna(distance, time);
+		prob = peopleList[live.rows[infectorSlot]].probability * prob;
+		if (classify(prob) == CLEAN)
+		{
+			peopleList[infectedRow].probability = 0;
+			liveRemove(&live, infectedId);
+		}
+		else
+		{
+			peopleList[infectedRow].probability = prob;
+			success = liveInsert(&live, infectedId, infectedRow);
+		}
+	}
+	statsAdd(&stats.rowsParsed, meetings + 1);
+	statsAdd(&stats.meetingsApplied, meetings);
+	statsAdd(&stats.lookups, 2 * meetings + searches); // every meeting probes the live set twice
+	statsAdd(&stats.bytesRead, fileOffset(meetingsFile));
+	if (live.ids != NULL && live.rows != NULL)
+	{
+		trackMemory(MEMORY_INDEX, (sizeof(unsigned long int) + sizeof(RowIndex)) * live.capacity,
+					0);
+	}
+	free(live.ids);
+	free(live.rows);
+	if (!success)
+	{
+		beforeExitFailure(meetingsFile, error, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	if (fclose(meetingsFile) == EOF)
+	{
+		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+void statsAdd(uint64_t *const counter, uint64_t amount)
+{
+	__atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+int ringPush(SpscRing *const ring, MeetingsBlock *block, const int *stopped)
+{
+	uint64_t tail = ring->tail; // only this thread writes it
+	while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == RING_CAPACITY)
+	{
+		if (__atomic_load_n(stopped, __ATOMIC_RELAXED))
+		{
+			return FAILURE;
+		}
+		sched_yield();
+	}
+	ring->slots[tail & (RING_CAPACITY - 1)] = block;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return SUCCESS;
+}
+
+MeetingsBlock *ringPop(SpscRing *const ring, const int *stopped)
+{
+	uint64_t head = ring->head; // only this thread writes it
+	while (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head)
+	{
+		if (__atomic_load_n(stopped, __ATOMIC_RELAXED))
+		{
+			return NULL;
+		}
+		sched_yield();
+	}
+	MeetingsBlock *block = ring->slots[head & (RING_CAPACITY - 1)];
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return block;
+}
+
+void freeBlock(MeetingsBlock *block)
+{
+	if (block == NULL)
+	{
+		return;
+	}
+	trackMemory(MEMORY_PIPELINE, block->length + 1 + sizeof(MeetingRecord) * block->recordsCount,
+				0);
+	free(block->text);
+	free(block->records);
+	free(block);
+}
+
+MeetingsBlock *newBlock(BlockStatus status, char *text, size_t length)
+{
+	MeetingsBlock *block = (MeetingsBlock *) calloc(sizeof(MeetingsBlock), 1);
+	if (block == NULL)
+	{
+		free(text);
+		return NULL;
+	}
+	block->status = status;
+	block->text = text;
+	block->length = text != NULL ? length : 0;
+	trackMemory(MEMORY_PIPELINE, 0, block->length + 1);
+	return block;
+}
+
+void *pipelineReader(void *pipeline)
+{
+	Pipeline *state = (Pipeline *) pipeline;
+	char *pending = NULL;
+	size_t pendingLength = 0;
+	uint64_t blocks = 0;
+	BlockStatus status = BLOCK_END;
+	while (!__atomic_load_n(&state->stopped, __ATOMIC_RELAXED))
+	{
+		double readStart = traceNow();
+		// every block starts with the part of a line that was left at the end of the previous one
+		char *text = (char *) malloc(pendingLength + state->blockSize + 1);
+		if (text == NULL)
+		{
+			status = BLOCK_ERROR;
+			break;
+		}
+		if (pendingLength > 0)
+		{
+			memcpy(text, pending, pendingLength);
+		}
+		free(pending);
+		pending = NULL;
+		size_t got = fread(text + pendingLength, 1, state->blockSize, state->meetingsFile);
+		size_t length = pendingLength + got;
+		state->bytesRead += got;
+		int atEnd = got < state->blockSize;
+		size_t cut = length;
+		if (!atEnd)
+		{
+			while (cut > 0 && text[cut - 1] != '\n')
+			{
+				--cut;
+			}
+		}
+		pendingLength = length - cut;
+		if (pendingLength > 0)
+		{
+			pending = (char *) malloc(pendingLength);
+			if (pending == NULL)
+			{
+				free(text);
+				status = BLOCK_ERROR;
+				break;
+			}
+			memcpy(pending, text + cut, pendingLength);
+		}
+		if (cut == 0) // no whole line yet, the next read continues it
+		{
+			free(text);
+		}
+		else
+		{
+			text[cut] = '\0';
+			MeetingsBlock *block = newBlock(BLOCK_DATA, text, cut);
+			traceSpan("read block", "pipeline", readStart, (long) blocks);
+			if (block == NULL ||
+				!ringPush(&state->toParsers[blocks % state->parsers], block, &state->stopped))
+			{
+				freeBlock(block);
+				status = BLOCK_ERROR;
+				break;
+			}
+			++blocks;
+		}
+		if (atEnd)
+		{
+			status = ferror(state->meetingsFile) ? BLOCK_ERROR : BLOCK_END;
+			break;
+		}
+	}
+	free(pending);
+	// the end reaches the parser of the next block first, so the propagation sees it in turn
+	for (int i = 0; i < state->parsers; ++i)
+	{
+		MeetingsBlock *end = newBlock(status, NULL, 0);
+		if (end == NULL || !ringPush(&state->toParsers[(blocks + i) % state->parsers], end,
+									 &state->stopped))
+		{
+			freeBlock(end);
+			__atomic_store_n(&state->stopped, SUCCESS, __ATOMIC_RELAXED);
+		}
+	}
+	return NULL;
+}
+
+void *pipelineParser(void *task)
+{
+	Pipeline *state = ((ParserTask *) task)->pipeline;
+	int index = ((ParserTask *) task)->index;
+	MeetingsBlock *block;
+	while ((block = ringPop(&state->toParsers[index], &state->stopped)) != NULL)
+	{
+		int last = block->status != BLOCK_DATA;
+		if (!last)
+		{
+			double parseStart = traceNow();
+			int lines = 1;
+			for (char *c = block->text; *c != '\0'; ++c)
+			{
+				lines += *c == '\n';
+			}
+			block->records = (MeetingRecord *) malloc(sizeof(MeetingRecord) * lines);
+			if (block->records == NULL)
+			{
+				block->status = BLOCK_ERROR;
+			}
+			else
+			{
+				trackMemory(MEMORY_PIPELINE, 0, sizeof(MeetingRecord) * lines);
+				block->recordsCount = lines; // the memory, until all the records are counted
+			}
+			char *line = block->text;
+			int count = 0;
+			while (block->status == BLOCK_DATA && *line != '\0')
+			{
+				char *next = strchr(line, '\n');
+				if (next != NULL)
+				{
+					*next = '\0';
+				}
+				if (resolveMeeting(state->peopleList, state->peopleListSize, line,
+								   &block->records[count]) == FAILURE)
+				{
+					block->status = BLOCK_ERROR;
+				}
+				++count;
+				line = next != NULL ? next + 1 : line + strlen(line);
+			}
+			if (block->records != NULL)
+			{
+				trackMemory(MEMORY_PIPELINE, sizeof(MeetingRecord) * lines,
+							sizeof(MeetingRecord) * count);
+				block->recordsCount = count;
+			}
+			traceSpan("parse block", "pipeline", parseStart, index);
+		}
+		if (!ringPush(&state->toPropagation[index], block, &state->stopped))
+		{
+			freeBlock(block);
+			return NULL;
+		}
+		if (last)
+		{
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+void readMeetingsFilePipelined(FILE *meetingsFile, Person *const peopleList, size_t peopleListSize,
+							   int parsers, size_t blockSize)
+{
+	char line[MAX_LINE_LENGTH];
+	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) == NULL) //if file is empty, close it and return
+	{
+		if (fclose(meetingsFile) == EOF)
+		{
+			fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		}
+		return;
+	}
+	RowIndex sickRow = findRow(peopleList, peopleListSize, strtoul(line, NULL, DECIMAL_BASE));
+	if (sickRow == NOT_FOUND)
+	{
+		beforeExitFailure(meetingsFile, IN_FILE_ERROR, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	peopleList[sickRow].probability = 1;
+	if (parsers <= 0)
+	{
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		parsers = processors > PIPELINE_RESERVED_THREADS ?
+				  (int) processors - PIPELINE_RESERVED_THREADS : 1;
+	}
+	Pipeline pipeline = {meetingsFile, peopleList, peopleListSize, blockSize, parsers, NULL, NULL,
+						 FAILURE, 0};
+	pipeline.toParsers = (SpscRing *) calloc(sizeof(SpscRing), parsers);
+	pipeline.toPropagation = (SpscRing *) calloc(sizeof(SpscRing), parsers);
+	ParserTask *tasks = (ParserTask *) malloc(sizeof(ParserTask) * parsers);
+	pthread_t *threads = (pthread_t *) malloc(sizeof(pthread_t) * (parsers + 1));
+	const char *error = NULL;
+	int started = 0;
+	if (pipeline.toParsers == NULL || pipeline.toPropagation == NULL || tasks == NULL ||
+		threads == NULL)
+	{
+		error = STANDARD_LIB_ERR_MSG;
+	}
+	for (; error == NULL && started < parsers; ++started)
+	{
+		tasks[started] = (ParserTask) {&pipeline, started};
+		if (pthread_create(&threads[started], NULL, pipelineParser, &tasks[started]) != 0)
+		{
+			error = STANDARD_LIB_ERR_MSG;
+			break;
+		}
+	}
+	if (error == NULL && pthread_create(&threads[started], NULL, pipelineReader, &pipeline) == 0)
+	{
+		++started;
+	}
+	else
+	{
+		error = STANDARD_LIB_ERR_MSG;
+	}
+	uint64_t meetings = 0;
+	for (uint64_t blocks = 0; error == NULL; ++blocks)
+	{
+		MeetingsBlock *block = ringPop(&pipeline.toPropagation[blocks % parsers],
+									   &pipeline.stopped);
+		if (block == NULL || block->status != BLOCK_DATA)
+		{
+			error = block == NULL || block->status == BLOCK_ERROR ? IN_FILE_ERROR : NULL;
+			freeBlock(block);
+			break;
+		}
+		double applyStart = traceNow();
+		for (int i = 0; i < block->recordsCount; ++i)
+		{
+			const MeetingRecord *meeting = &block->records[i];
+			float prob = crna(meeting->distance, meeting->time);
+			peopleList[meeting->infectedRow].probability =
+					peopleList[meeting->infectorRow].probability * prob;
+		}
+		meetings += block->recordsCount;
+		traceSpan("apply block", "pipeline", applyStart, (long) blocks);
+		freeBlock(block);
+	}
+	if (error != NULL)
+	{
+		__atomic_store_n(&pipeline.stopped, SUCCESS, __ATOMIC_RELAXED);
+	}
+	for (int i = 0; i < started; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	// all the threads are done, whatever is left in the rings is freed
+	__atomic_store_n(&pipeline.stopped, SUCCESS, __ATOMIC_RELAXED);
+	for (int i = 0; pipeline.toParsers != NULL && pipeline.toPropagation != NULL && i < parsers;
+		 ++i)
+	{
+		MeetingsBlock *block;
+		while ((block = ringPop(&pipeline.toParsers[i], &pipeline.stopped)) != NULL)
+		{
+			freeBlock(block);
+		}
+		while ((block = ringPop(&pipeline.toPropagation[i], &pipeline.stopped)) != NULL)
+		{
+			freeBlock(block);
+		}
+	}
+	free(pipeline.toParsers);
+	free(pipeline.toPropagation);
+	free(tasks);
+	free(threads);
+	statsAdd(&stats.rowsParsed, meetings + 1);
+	statsAdd(&stats.meetingsApplied, meetings);
+	statsAdd(&stats.lookups, 2 * meetings + 1);
+	statsAdd(&stats.bytesRead, pipeline.bytesRead + strlen(line));
+	if (error != NULL)
+	{
+		beforeExitFailure(meetingsFile, error, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+	if (fclose(meetingsFile) == EOF)
+	{
+		beforeExitFailure(NULL, STANDARD_LIB_ERR_MSG, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int tokenizeMeeting(char *line, RawMeeting *const meeting)
+{
+	char *rest = NULL;
+	char *fields[4] = {strtok_r(line, SEPARATOR LINE_END, &rest), NULL, NULL, NULL};
+	for (int i = 1; i < 4 && fields[i - 1] != NULL; ++i)
+	{
+		fields[i] = strtok_r(NULL, SEPARATOR LINE_END, &rest);
+	}
+	if (fields[3] == NULL)
+	{
+		return FAILURE;
+	}
+	meeting->infectorId = strtoul(fields[0], NULL, DECIMAL_BASE);
+	meeting->infectedId = strtoul(fields[1], NULL, DECIMAL_BASE);
+	meeting->distance = strtof(fields[2], NULL);
+	meeting->time = strtof(fields[3], NULL);
+	return SUCCESS;
+}
+
+void *tokenizeMeetings(void *tokenizer)
+{
+	MeetingsTokenizer *state = (MeetingsTokenizer *) tokenizer;
+	double start = traceNow();
+	char line[MAX_LINE_LENGTH];
+	state->empty = fgets(line, MAX_LINE_LENGTH, state->meetingsFile) == NULL;
+	if (!state->empty)
+	{
+		state->sickId = strtoul(line, NULL, DECIMAL_BASE);
+	}
+	while (!state->empty && state->error == NULL &&
+		   fgets(line, MAX_LINE_LENGTH, state->meetingsFile))
+	{
+		if (state->meetingsAmount == state->capacity)
+		{
+			size_t capacity = state->capacity > 0 ? state->capacity * ALLOC_SIZE : ALLOC_SIZE;
+			RawMeeting *temp = (RawMeeting *) realloc(state->meetings,
+													  sizeof(RawMeeting) * capacity);
+			if (temp == NULL)
+			{
+				state->error = STANDARD_LIB_ERR_MSG;
+				break;
+			}
+			trackMemory(MEMORY_PIPELINE, sizeof(RawMeeting) * state->capacity,
+						sizeof(RawMeeting) * capacity);
+			state->meetings = temp;
+			state->capacity = capacity;
+		}
+		if (tokenizeMeeting(line, &state->meetings[state->meetingsAmount]) == FAILURE)
+		{
+			state->error = IN_FILE_ERROR;
+		}
+		++state->meetingsAmount;
+	}
+	state->bytesRead = fileOffset(state->meetingsFile);
+	if (fclose(state->meetingsFile) == EOF && state->error == NULL)
+	{
+		state->error = STANDARD_LIB_ERR_MSG;
+	}
+	traceSpan("tokenize meetings", "meetings", start, (long) state->meetingsAmount);
+	return NULL;
+}
+
+int startTokenizer(MeetingsTokenizer *const tokenizer, FILE *meetingsFile)
+{
+	memset(tokenizer, 0, sizeof(MeetingsTokenizer));
+	tokenizer->meetingsFile = meetingsFile;
+	return pthread_create(&tokenizer->thread, NULL, tokenizeMeetings, tokenizer) == 0;
+}
+
+void applyTokenizedMeetings(MeetingsTokenizer *const tokenizer, Person *const peopleList,
+							size_t peopleListSize)
+{
+	pthread_join(tokenizer->thread, NULL);
+	const char *error = tokenizer->error;
+	RowIndex sickRow = tokenizer->empty ? NOT_FOUND :
+					   findRow(peopleList, peopleListSize, tokenizer->sickId);
+	if (!tokenizer->empty && sickRow == NOT_FOUND)
+	{
+		error = IN_FILE_ERROR;
+	}
+	else if (!tokenizer->empty)
+	{
+		peopleList[sickRow].probability = 1;
+	}
+	size_t meetings = 0;
+	for (; error == NULL && meetings < tokenizer->meetingsAmount; ++meetings)
+	{
+		const RawMeeting *meeting = &tokenizer->meetings[meetings];
+		RowIndex infectorRow = findRow(peopleList, peopleListSize, meeting->infectorId);
+		RowIndex infectedRow = findRow(peopleList, peopleListSize, meeting->infectedId);
+		if (infectorRow == NOT_FOUND || infectedRow == NOT_FOUND)
+		{
+			error = IN_FILE_ERROR;
+			break;
+		}
+		float prob = crna(meeting->distance, meeting->time);
+		peopleList[infectedRow].probability = peopleList[infectorRow].probability * prob;
+	}
+	trackMemory(MEMORY_PIPELINE, sizeof(RawMeeting) * tokenizer->capacity, 0);
+	free(tokenizer->meetings);
+	tokenizer->meetings = NULL;
+	if (!tokenizer->empty)
+	{
+		statsAdd(&stats.rowsParsed, tokenizer->meetingsAmount + 1);
+		statsAdd(&stats.meetingsApplied, meetings);
+		statsAdd(&stats.lookups, 2 * meetings + 1);
+	}
+	statsAdd(&stats.bytesRead, tokenizer->bytesRead);
+	if (error != NULL)
+	{
+		beforeExitFailure(NULL, error, peopleList, peopleListSize);
+		exit(EXIT_FAILURE);
+	}
+}
+
+void trackMemory(MemorySubsystem subsystem, uint64_t oldBytes, uint64_t newBytes)
+{
+	if (!stats.enabled || oldBytes == newBytes)
+	{
+		return;
+	}
+	MemoryUsage *usage = &stats.memory[subsystem];
+	if (newBytes != 0)
+	{
+		statsAdd(&usage->calls, 1);
+		statsAdd(&usage->bytes, newBytes);
+	}
+	// unsigned arithmetic, so adding the difference also works when the block shrinks
+	uint64_t difference = newBytes - oldBytes;
+	raisePeak(&usage->peak, __atomic_add_fetch(&usage->live, difference, __ATOMIC_RELAXED));
+	raisePeak(&stats.memoryPeak, __atomic_add_fetch(&stats.memoryLive, difference,
+													__ATOMIC_RELAXED));
+}
+
+void raisePeak(uint64_t *const peak, uint64_t value)
+{
+	uint64_t current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+	while (value > current && !__atomic_compare_exchange_n(peak, &current, value, 1,
+															 __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+		// current was updated to the peak, try again
+	}
+}
+
+uint64_t fileOffset(FILE *const file)
+{
+	long offset = ftell(file);
+	return offset > 0 ? (uint64_t) offset : 0;
+}
+
+double monotonicSeconds(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double) time.tv_sec + (double) time.tv_nsec / NANOS_IN_SECOND;
+}
+
+void phaseBegin(Phase phase)
+{
+	if (perf.enabled)
+	{
+		for (int event = 0; event < PERF_EVENTS; ++event)
+		{
+			perf.start[phase][event] = perfRead(perf.fds[event]);
+		}
+	}
+	if (!stats.enabled && !tracer.enabled)
+	{
+		return;
+	}
+	stats.phaseStartBytes[phase] = stats.bytesRead + stats.bytesWritten;
+	stats.phaseStart[phase] = monotonicSeconds();
+}
+
+void phaseEnd(Phase phase, uint64_t rows)
+{
+	if (perf.enabled)
+	{
+		for (int event = 0; event < PERF_EVENTS; ++event)
+		{
+			uint64_t value = perfRead(perf.fds[event]);
+			if (value != NO_COUNT && perf.start[phase][event] != NO_COUNT)
+			{
+				perf.values[phase][event] += value - perf.start[phase][event];
+			}
+		}
+		perf.ran[phase] = SUCCESS;
+	}
+	traceSpan(phaseNames[phase], "phase", stats.phaseStart[phase], NO_DETAIL);
+	if (!stats.enabled)
+	{
+		return;
+	}
+	stats.phaseSeconds[phase] += monotonicSeconds() - stats.phaseStart[phase];
+	stats.phaseRows[phase] += rows;
+	stats.phaseBytes[phase] += stats.bytesRead + stats.bytesWritten - stats.phaseStartBytes[phase];
+	stats.phaseRan[phase] = SUCCESS;
+}
+
+void printStats(FILE *const report)
+{
+	double total = 0;
+	fprintf(report, "%-18s %10s %12s %14s %10s %10s\n", "phase", "seconds", "rows", "rows/s", "MB",
+			"MB/s");
+	for (int phase = 0; phase < PHASE_AMOUNT; ++phase)
+	{
+		if (!stats.phaseRan[phase])
+		{
+			continue;
+		}
+		double seconds = stats.phaseSeconds[phase];
+		double megabytes = stats.phaseBytes[phase] / BYTES_IN_MEGABYTE;
+		total += seconds;
+		fprintf(report, "%-18s %10.6f %12llu %14.0f %10.2f %10.2f\n", phaseNames[phase], seconds,
+				(unsigned long long) stats.phaseRows[phase],
+				seconds > 0 ? stats.phaseRows[phase] / seconds : 0, megabytes,
+				seconds > 0 ? megabytes / seconds : 0);
+	}
+	fprintf(report, "%-18s %10.6f\n", "total", total);
+	fprintf(report, "rows parsed %llu, meetings applied %llu, bytes read %llu, bytes written %llu, "
+					"lookups %llu, allocations %llu\n", (unsigned long long) stats.rowsParsed,
+			(unsigned long long) stats.meetingsApplied, (unsigned long long) stats.bytesRead,
+			(unsigned long long) stats.bytesWritten, (unsigned long long) stats.lookups,
+			(unsigned long long) stats.allocations);
+	fprintf(report, "%-18s %10s %12s %14s %10s\n", "memory", "calls", "allocated MB", "live MB",
+			"peak MB");
+	for (int subsystem = 0; subsystem < MEMORY_AMOUNT; ++subsystem)
+	{
+		const MemoryUsage *usage = &stats.memory[subsystem];
+		fprintf(report, "%-18s %10llu %12.2f %14.2f %10.2f\n", memoryNames[subsystem],
+				(unsigned long long) usage->calls, usage->bytes / BYTES_IN_MEGABYTE,
+				usage->live / BYTES_IN_MEGABYTE, usage->peak / BYTES_IN_MEGABYTE);
+	}
+	struct rusage usage;
+	double residentMegabytes = getrusage(RUSAGE_SELF, &usage) == 0 ?
+							   usage.ru_maxrss * BYTES_IN_KILOBYTE / BYTES_IN_MEGABYTE : 0;
+	fprintf(report, "peak of all the subsystems %.2f MB, maximal resident set %.2f MB\n",
+			stats.memoryPeak / BYTES_IN_MEGABYTE, residentMegabytes);
+	if (alerter.alerts > 0)
+	{
+		fprintf(report, "alerts %llu, detection to alert %.2f us on average, %.2f us at most\n",
+				(unsigned long long) alerter.alerts,
+				alerter.latencySum / alerter.alerts * MICROS_IN_SECOND,
+				alerter.latencyMax * MICROS_IN_SECOND);
+	}
+}
+
+int perfOpen(void)
+{
+	int opened = 0;
+	for (int event = 0; event < PERF_EVENTS; ++event)
+	{
+		perf.fds[event] = -1;
+	}
+#ifdef __linux__
+	const uint64_t configs[PERF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+										   PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+	for (int event = 0; event < PERF_EVENTS; ++event)
+	{
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = configs[event];
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.inherit = 1; // the batch workers are counted too
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		perf.fds[event] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		opened += perf.fds[event] != -1;
+	}
+#endif
+	return opened;
+}
+
+uint64_t perfRead(int fd)
+{
+	uint64_t values[3]; // the value, the time enabled and the time running
+	if (fd == -1 || read(fd, values, sizeof(values)) != (ssize_t) sizeof(values))
+	{
+		return NO_COUNT;
+	}
+	if (values[2] == 0)
+	{
+		return 0;
+	}
+	return values[2] < values[1] ? (uint64_t) ((double) values[0] * values[1] / values[2]) :
+		   values[0];
+}
+
+void printPerf(FILE *const report)
+{
+	fprintf(report, "%-18s", "phase");
+	for (int event = 0; event < PERF_EVENTS; ++event)
+	{
+		fprintf(report, " %15s", perfEventNames[event]);
+	}
+	fprintf(report, " %8s\n", "IPC");
+	for (int phase = 0; phase < PHASE_AMOUNT; ++phase)
+	{
+		if (!perf.ran[phase])
+		{
+			continue;
+		}
+		fprintf(report, "%-18s", phaseNames[phase]);
+		for (int event = 0; event < PERF_EVENTS; ++event)
+		{
+			if (perf.fds[event] == -1)
+			{
+				fprintf(report, " %15s", "n/a");
+			}
+			else
+			{
+				fprintf(report, " %15llu", (unsigned long long) perf.values[phase][event]);
+			}
+		}
+		uint64_t cycles = perf.values[phase][0];
+		if (perf.fds[0] == -1 || perf.fds[1] == -1 || cycles == 0)
+		{
+			fprintf(report, " %8s\n", "n/a");
+		}
+		else
+		{
+			fprintf(report, " %8.2f\n", (double) perf.values[phase][1] / cycles);
+		}
+	}
+	for (int event = 0; event < PERF_EVENTS; ++event)
+	{
+		if (perf.fds[event] != -1)
+		{
+			close(perf.fds[event]);
+			perf.fds[event] = -1;
+		}
+	}
+}
+
+TraceBuffer *threadTraceBuffer(void)
+{
+	if (threadTrace != NULL)
+	{
+		return threadTrace;
+	}
+	TraceBuffer *buffer = (TraceBuffer *) calloc(sizeof(TraceBuffer), 1);
+	if (buffer == NULL)
+	{
+		return NULL;
+	}
+	buffer->thread = __atomic_add_fetch(&tracer.threads, 1, __ATOMIC_RELAXED);
+	buffer->next = __atomic_load_n(&tracer.buffers, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&tracer.buffers, &buffer->next, buffer, 1,
+										__ATOMIC_RELEASE, __ATOMIC_RELAXED))
+	{
+		// buffer->next was updated to the current head, try again
+	}
+	threadTrace = buffer;
+	return buffer;
+}
+
+double traceNow(void)
+{
+	return tracer.enabled ? monotonicSeconds() : 0;
+}
+
+void traceSpan(const char *name, const char *category, double start, long detail)
+{
+	if (!tracer.enabled)
+	{
+		return;
+	}
+	double end = monotonicSeconds();
+	TraceBuffer *buffer = threadTraceBuffer();
+	if (buffer == NULL)
+	{
+		return;
+	}
+	if (buffer->count == buffer->capacity)
+	{
+		int capacity = buffer->capacity == 0 ? TRACE_CAPACITY : buffer->capacity * ALLOC_SIZE;
+		TraceEvent *temp = (TraceEvent *) realloc(buffer->events, sizeof(TraceEvent) * capacity);
+		if (temp == NULL)
+		{
+			++buffer->dropped;
+			return;
+		}
+		buffer->events = temp;
+		buffer->capacity = capacity;
+	}
+	buffer->events[buffer->count] = (TraceEvent) {name, category, start, end, detail};
+	++buffer->count;
+}
+
+int writeTrace(void)
+{
+	FILE *traceFile = fopen(tracer.path, "w");
+	TraceBuffer *buffer = __atomic_load_n(&tracer.buffers, __ATOMIC_ACQUIRE);
+	double origin = 0;
+	for (TraceBuffer *it = buffer; it != NULL; it = it->next)
+	{
+		for (int i = 0; i < it->count; ++i)
+		{
+			if (origin == 0 || it->events[i].start < origin)
+			{
+				origin = it->events[i].start;
+			}
+		}
+	}
+	int pid = (int) getpid();
+	uint64_t dropped = 0;
+	const char *separator = "\n";
+	if (traceFile != NULL)
+	{
+		fprintf(traceFile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+	}
+	while (buffer != NULL)
+	{
+		if (traceFile != NULL)
+		{
+			fprintf(traceFile, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, "
+							   "\"tid\": %d, \"args\": {\"name\": \"%s %d\"}}", separator, pid,
+					buffer->thread, buffer->thread == 1 ? "main" : "worker", buffer->thread);
+			separator = ",\n";
+			for (int i = 0; i < buffer->count; ++i)
+			{
+				const TraceEvent *event = &buffer->events[i];
+				fprintf(traceFile, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", "
+								   "\"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d",
+						event->name, event->category, (event->start - origin) * MICROS_IN_SECOND,
+						(event->end - event->start) * MICROS_IN_SECOND, pid, buffer->thread);
+				if (event->detail != NO_DETAIL)
+				{
+					fprintf(traceFile, ", \"args\": {\"n\": %ld}", event->detail);
+				}
+				fprintf(traceFile, "}");
+			}
+		}
+		dropped += buffer->dropped;
+		TraceBuffer *next = buffer->next;
+		free(buffer->events);
+		free(buffer);
+		buffer = next;
+	}
+	tracer.buffers = NULL;
+	threadTrace = NULL;
+	if (traceFile == NULL)
+	{
+		return FAILURE;
+	}
+	fprintf(traceFile, "\n], \"otherData\": {\"droppedEvents\": %llu}}\n",
+			(unsigned long long) dropped);
+	return fclose(traceFile) != EOF;
+}
+
+int openAlerts(const char *path, size_t peopleListSize)
+{
+	alerter.file = strcmp(path, ALERTS_STDOUT) == 0 ? stdout : fopen(path, "w");
+	alerter.classes = (unsigned char *) calloc(sizeof(unsigned char), peopleListSize + 1);
+	if (alerter.file == NULL || alerter.classes == NULL)
+	{
+		if (alerter.file != NULL && alerter.file != stdout)
+		{
+			fclose(alerter.file);
+		}
+		free(alerter.classes);
+		alerter.file = NULL;
+		alerter.classes = NULL;
+		return FAILURE;
+	}
+	alerter.classesCount = peopleListSize;
+	trackMemory(MEMORY_CLASSES, 0, peopleListSize);
+	alerter.start = monotonicSeconds();
+	return SUCCESS;
+}
+
+void alertIfCrossed(Person *const peopleList, RowIndex row, uint64_t meeting)
+{
+	Classification classification = classify(peopleList[row].probability);
+	if (classification == alerter.classes[row])
+	{
+		return;
+	}
+	double detected = monotonicSeconds();
+	fprintf(alerter.file, ALERT_FORMAT, (detected - alerter.start) * MICROS_IN_SECOND,
+			(unsigned long long) meeting, peopleList[row].id, peopleList[row].name,
+			classNames[alerter.classes[row]], classNames[classification],
+			peopleList[row].probability);
+	fflush(alerter.file);
+	double latency = monotonicSeconds() - detected;
+	alerter.classes[row] = classification;
+	++alerter.alerts;
+	alerter.latencySum += latency;
+	if (latency > alerter.latencyMax)
+	{
+		alerter.latencyMax = latency;
+	}
+}
+
+int closeAlerts(void)
+{
+	int closed = alerter.file == stdout ? fflush(stdout) != EOF : fclose(alerter.file) != EOF;
+	trackMemory(MEMORY_CLASSES, alerter.classesCount, 0);
+	free(alerter.classes);
+	alerter.file = NULL;
+	alerter.classes = NULL;
+	return closed;
+}
+
+int endRun(int exitCode)
+{
+	if (stats.enabled)
+	{
+		printStats(stderr);
+	}
+	if (perf.enabled)
+	{
+		printPerf(stderr);
+	}
+	if (tracer.enabled && writeTrace() == FAILURE)
+	{
+		fprintf(stderr, OUT_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	return exitCode;
+}
+
+int argcCheck(int argc, int expected)
+{
+	if (argc != expected)  // ERROR- wrong number of arguments
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return FAILURE;
+	}
+	return SUCCESS;
+}
+
+int parseArguments(int argc, char *argv[], Config *const config)
+{
+	config->binaryMeetings = FAILURE;
+	config->convert = FAILURE;
+	config->compact = FAILURE;
+	config->serve = FAILURE;
+	config->batch = FAILURE;
+	config->threads = 0;
+	config->multiSource = FAILURE;
+	config->prune = FAILURE;
+	config->pipeline = FAILURE;
+	config->overlap = FAILURE;
+	config->stats = FAILURE;
+	config->perf = FAILURE;
+	config->tracePath = NULL;
+	config->alertsPath = NULL;
+	config->checkpointPath = NULL;
+	config->deltaPath = NULL;
+	config->cacheDir = NULL;
+	config->external = FAILURE;
+	config->memoryBudget = (size_t) EXTERNAL_DEFAULT_BUDGET * BYTES_IN_MEGABYTE;
+	int i = 1;
+	for (; i < argc && strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0; ++i)
+	{
+		if (strcmp(argv[i], BINARY_OPTION) == 0)
+		{
+			config->binaryMeetings = SUCCESS;
+		}
+		else if (strcmp(argv[i], CONVERT_OPTION) == 0)
+		{
+			config->convert = SUCCESS;
+		}
+		else if (strcmp(argv[i], COMPACT_OPTION) == 0)
+		{
+			config->compact = SUCCESS;
+		}
+		else if (strcmp(argv[i], SERVE_OPTION) == 0)
+		{
+			config->serve = SUCCESS;
+		}
+		else if (strcmp(argv[i], BATCH_OPTION) == 0)
+		{
+			config->batch = SUCCESS;
+		}
+		else if (strcmp(argv[i], MULTI_SOURCE_OPTION) == 0)
+		{
+			config->multiSource = SUCCESS;
+		}
+		else if (strcmp(argv[i], PRUNE_OPTION) == 0)
+		{
+			config->prune = SUCCESS;
+		}
+		else if (strcmp(argv[i], PIPELINE_OPTION) == 0)
+		{
+			config->pipeline = SUCCESS;
+		}
+		else if (strcmp(argv[i], OVERLAP_OPTION) == 0)
+		{
+			config->overlap = SUCCESS;
+		}
+		else if (strcmp(argv[i], STATS_OPTION) == 0)
+		{
+			config->stats = SUCCESS;
+		}
+		else if (strcmp(argv[i], PERF_OPTION) == 0)
+		{
+			config->perf = SUCCESS;
+		}
+		else if (strcmp(argv[i], TRACE_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->tracePath = argv[i];
+		}
+		else if (strcmp(argv[i], ALERTS_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->alertsPath = argv[i];
+		}
+		else if (strcmp(argv[i], CHECKPOINT_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->checkpointPath = argv[i];
+		}
+		else if (strcmp(argv[i], DELTA_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->deltaPath = argv[i];
+		}
+		else if (strcmp(argv[i], CACHE_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->cacheDir = argv[i];
+		}
+		else if (strcmp(argv[i], EXTERNAL_OPTION) == 0)
+		{
+			config->external = SUCCESS;
+		}
+		else if (strcmp(argv[i], MEMORY_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->memoryBudget = (size_t) (strtod(argv[i], NULL) * BYTES_IN_MEGABYTE);
+		}
+		else if (strcmp(argv[i], THREADS_OPTION) == 0 && i + 1 < argc)
+		{
+			++i;
+			config->threads = (int) strtol(argv[i], NULL, DECIMAL_BASE);
+		}
+		else // ERROR- unknown option
+		{
+			fprintf(stderr, USAGE_ERROR);
+			return FAILURE;
+		}
+	}
+	// the arguments after the options are counted as if they started at argv[1]
+	config->firstArg = i - 1;
+	config->argsAmount = argc - config->firstArg;
+	int modes = config->convert + config->binaryMeetings + config->serve + config->batch +
+				config->multiSource + config->prune + config->pipeline + config->overlap +
+				config->external;
+	// the alerts and the checkpoint follow the meetings one by one, as the regular mode does
+	int followsMeetings = config->alertsPath != NULL || config->checkpointPath != NULL;
+	// the delta is of the single output file of a run
+	int singleOutput = config->convert + config->serve + config->batch + config->multiSource == 0;
+	// a cached output replaces the whole run, so the run can't have any other effect
+	int sideEffects = followsMeetings || config->deltaPath != NULL;
+	if (modes > 1 || (followsMeetings && modes > 0) || (config->compact && !config->convert) ||
+		(config->deltaPath != NULL && (!singleOutput || config->external)) ||
+		(config->cacheDir != NULL && (!singleOutput || sideEffects)))
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return FAILURE;
+	}
+	if (config->batch)
+	{
+		// any amount of meetings' files, but at least one
+		return argcCheck(config->argsAmount < BATCH_ARGS_AMOUNT ? 0 : BATCH_ARGS_AMOUNT,
+						 BATCH_ARGS_AMOUNT);
+	}
+	if (argcCheck(config->argsAmount, config->convert ? CONVERT_ARGS_AMOUNT : ARGS_AMOUNT) ==
+		FAILURE)
+	{
+		return FAILURE;
+	}
+	// a checkpoint is an offset in the meetings' file, and the cache hashes all of it, that a
+	// stream doesn't have
+	if ((config->checkpointPath != NULL || config->cacheDir != NULL) &&
+		strcmp(argv[config->firstArg + MEETINGS_FILE_INDEX], STDIN_PATH) == 0)
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return FAILURE;
+	}
+	return SUCCESS;
+}
+
+#ifndef SPREADER_DETECTOR_LIBRARY
+int main(int argc, char *argv[])
+{
+	Config config;
+	if (parseArguments(argc, argv, &config) == FAILURE)
+	{
+		return EXIT_FAILURE;
+	}
+	stats.enabled = config.stats;
+	tracer.enabled = config.tracePath != NULL;
+	tracer.path = config.tracePath;
+	perf.enabled = config.perf && perfOpen() > 0;
+	if (config.perf && !perf.enabled)
+	{
+		fprintf(stderr, PERF_UNAVAILABLE_MSG);
+	}
+	argv += config.firstArg;
+	char *cachedPath = NULL;
+	if (config.cacheDir != NULL)
+	{
+		cachedPath = cachedOutputPath(config.cacheDir, argv[PEOPLE_FILE_INDEX],
+									  argv[MEETINGS_FILE_INDEX], &config);
+		if (cachedPath == NULL)
+		{
+			fprintf(stderr, IN_FILE_ERROR);
+			return EXIT_FAILURE;
+		}
+		if (restoreCachedOutput(cachedPath))
+		{
+			free(cachedPath);
+			return endRun(EXIT_SUCCESS);
+		}
+	}
+	if (config.external)
+	{
+		int exitCode = runExternal(argv[PEOPLE_FILE_INDEX], argv[MEETINGS_FILE_INDEX], OUTPUT_FILE,
+								   config.memoryBudget);
+		if (exitCode == EXIT_SUCCESS && cachedPath != NULL &&
+			storeCachedOutput(cachedPath) == FAILURE)
+		{
+			fprintf(stderr, CACHE_STORE_MSG);
+		}
+		free(cachedPath);
+		return endRun(exitCode);
+	}
+	MeetingsTokenizer tokenizer;
+	if (config.overlap)
+	{
+		// the meetings are tokenized while the people are read and sorted
+		FILE *meetingsFile = openMeetingsFile(argv[MEETINGS_FILE_INDEX], "r");
+		if (meetingsFile == NULL || startTokenizer(&tokenizer, meetingsFile) == FAILURE)
+		{
+			fprintf(stderr, meetingsFile == NULL ? IN_FILE_ERROR : STANDARD_LIB_ERR_MSG);
+			return EXIT_FAILURE;
+		}
+	}
+	phaseBegin(PHASE_READ_PEOPLE);
+	FILE *peopleFile = fopen(argv[PEOPLE_FILE_INDEX], "r");
+	if (peopleFile == NULL)
+	{
+		fprintf(stderr, IN_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	Person *peopleList = NULL;
+	// after this, peopleFile is closed
+	size_t peopleListSize = readPeopleFile(peopleFile, &peopleList);
+	phaseEnd(PHASE_READ_PEOPLE, peopleListSize);
+	phaseBegin(PHASE_SORT_BY_ID);
+	sortById(&peopleList, peopleListSize); // so it would be quicker to update the probabilities
+	phaseEnd(PHASE_SORT_BY_ID, peopleListSize);
+	if (config.serve)
+	{
+		int exitCode = serve(argv[SOCKET_PATH_INDEX], peopleList, peopleListSize);
+		freePeople(peopleList, peopleListSize);
+		return endRun(exitCode);
+	}
+	if (config.batch)
+	{
+		phaseBegin(PHASE_BATCH);
+		int exitCode = runBatch(peopleList, peopleListSize, &argv[MEETINGS_FILE_INDEX],
+								config.argsAmount - MEETINGS_FILE_INDEX, config.threads);
+		phaseEnd(PHASE_BATCH, stats.meetingsApplied);
+		freePeople(peopleList, peopleListSize);
+		return endRun(exitCode);
+	}
+	if (config.alertsPath != NULL && openAlerts(config.alertsPath, peopleListSize) == FAILURE)
+	{
+		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return EXIT_FAILURE;
+	}
+	phaseBegin(PHASE_READ_MEETINGS);
+	FILE *meetingsFile = NULL;
+	if (config.overlap)
+	{
+		applyTokenizedMeetings(&tokenizer, peopleList, peopleListSize);
+	}
+	else if ((meetingsFile = openMeetingsFile(argv[MEETINGS_FILE_INDEX],
+											  config.binaryMeetings ? "rb" : "r")) == NULL)
+	{
+		beforeExitFailure(NULL, IN_FILE_ERROR, peopleList, peopleListSize);
+		return EXIT_FAILURE;
+	}
+	if (config.convert)
+	{
+		// the binary file replaces the old one only once it's complete, so a conversion that failed
+		// leaves nothing that binary mode would read
+		char *tempPath = NULL;
+		FILE *binaryFile = openReplacement(argv[BINARY_FILE_INDEX], &tempPath);
+		if (binaryFile == NULL)
+		{
+			free(tempPath);
+			beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+			return EXIT_FAILURE;
+		}
+		// meetingsFile's closed
+		const char *error = convertMeetingsFile(meetingsFile, binaryFile, peopleList,
+												peopleListSize, config.compact);
+		if (!replaceFile(binaryFile, tempPath, argv[BINARY_FILE_INDEX], error == NULL) &&
+			error == NULL)
+		{
+			error = OUT_FILE_ERROR;
+		}
+		if (error != NULL)
+		{
+			beforeExitFailure(NULL, error, peopleList, peopleListSize);
+			return EXIT_FAILURE;
+		}
+		phaseEnd(PHASE_READ_MEETINGS, stats.rowsParsed - peopleListSize);
+		freePeople(peopleList, peopleListSize);
+		return endRun(EXIT_SUCCESS);
+	}
+	if (config.multiSource)
+	{
+		int exitCode = runMultiSource(meetingsFile, peopleList, peopleListSize); // it's closed
+		freePeople(peopleList, peopleListSize);
+		return endRun(exitCode);
+	}
+	if (config.binaryMeetings)
+	{
+		readBinaryMeetingsFile(meetingsFile, peopleList, peopleListSize); // meetingsFile's closed
+	}
+	else if (config.prune)
+	{
+		readMeetingsFilePruned(meetingsFile, peopleList, peopleListSize); // meetingsFile's closed
+	}
+	else if (config.pipeline)
+	{
+		// meetingsFile's closed
+		readMeetingsFilePipelined(meetingsFile, peopleList, peopleListSize, config.threads,
+								  PIPELINE_BLOCK);
+	}
+	else if (config.checkpointPath != NULL)
+	{
+		// meetingsFile's closed
+		readMeetingsFileIncremental(meetingsFile, peopleList, peopleListSize,
+									config.checkpointPath);
+	}
+	else if (!config.overlap)
+	{
+		readMeetingsFile(meetingsFile, peopleList, peopleListSize); // meetingsFile's closed
+	}
+	phaseEnd(PHASE_READ_MEETINGS, stats.meetingsApplied);
+	if (config.alertsPath != NULL && closeAlerts() == FAILURE)
+	{
+		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return EXIT_FAILURE;
+	}
+	if (config.deltaPath != NULL)
+	{
+		// only the changes are written, by id, so there's no need to sort by probability
+		phaseBegin(PHASE_WRITE_OUTPUT);
+		FILE *outputFile = fopen(OUTPUT_FILE, "w");
+		if (outputFile == NULL)
+		{
+			beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+			return EXIT_FAILURE;
+		}
+		// after this, outputFile is closed
+		size_t changed = writeDeltaOutput(outputFile, config.deltaPath, peopleList, peopleListSize);
+		phaseEnd(PHASE_WRITE_OUTPUT, changed);
+		freePeople(peopleList, peopleListSize);
+		return endRun(EXIT_SUCCESS);
+	}
+	phaseBegin(PHASE_SORT_BY_PROBABILITY);
+	sortByProbability(&peopleList, peopleListSize); // so we know what order to print in
+	phaseEnd(PHASE_SORT_BY_PROBABILITY, peopleListSize);
+	phaseBegin(PHASE_WRITE_OUTPUT);
+	FILE *outputFile = fopen(OUTPUT_FILE, "w");
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return EXIT_FAILURE;
+	}
+	writeOutput(outputFile, peopleList, peopleListSize); //after this, outputFile is closed
+	phaseEnd(PHASE_WRITE_OUTPUT, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	if (cachedPath != NULL && storeCachedOutput(cachedPath) == FAILURE)
+	{
+		fprintf(stderr, CACHE_STORE_MSG);
+	}
+	free(cachedPath);
+	return endRun(EXIT_SUCCESS);
 }
+#endif //SPREADER_DETECTOR_LIBRARY
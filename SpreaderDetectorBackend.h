@@ -0,0 +1,2120 @@
+/**
+ * @file SpreaderDetectorBackend.h
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief The definitions and the functions of the SpreaderDetectorBackend program, shared with the
+ * tools that are built from the same sources (the benchmarks)
+ *
+ * @section LICENSE
+ * This program is a free software.
+ */
+
+#ifndef SPREADERDETECTORBACKEND_H
+#define SPREADERDETECTORBACKEND_H
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "SpreaderDetectorParams.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def SUCCESS- a declaration for success in a function.
+ */
+#define SUCCESS 1
+
+/**
+ * @def FAILURE- a declaration for failure in a function.
+ */
+#define FAILURE 0
+
+/**
+ * @def ARGS_AMOUNT- the number of arguments in argv[]
+ */
+#define ARGS_AMOUNT 3
+
+/**
+ * @def CONVERT_ARGS_AMOUNT- the number of arguments in argv[] after the options, in convert mode
+ */
+#define CONVERT_ARGS_AMOUNT 4
+
+/**
+ * @def BINARY_FILE_INDEX- the binary meetings' file index in argv[] (after the options), in
+ * convert mode
+ */
+#define BINARY_FILE_INDEX 3
+
+/**
+ * @def SOCKET_PATH_INDEX- the socket's path index in argv[] (after the options), in server mode
+ */
+#define SOCKET_PATH_INDEX 2
+
+/**
+ * @def BATCH_ARGS_AMOUNT- the minimal number of arguments in argv[] (after the options), in batch
+ * mode
+ */
+#define BATCH_ARGS_AMOUNT 3
+
+/**
+ * @def OPTION_PREFIX- the prefix of every option in argv[]
+ */
+#define OPTION_PREFIX "--"
+
+/**
+ * @def BINARY_OPTION- the option that says the meetings' file is in the binary format
+ */
+#define BINARY_OPTION "--binary"
+
+/**
+ * @def CONVERT_OPTION- the option that converts a text meetings' file to the binary format
+ */
+#define CONVERT_OPTION "--convert"
+
+/**
+ * @def COMPACT_OPTION- the option that converts to the compact binary format, with a quantized
+ * infection factor in every meeting
+ */
+#define COMPACT_OPTION "--compact"
+
+/**
+ * @def SERVE_OPTION- the option that keeps the people in memory and serves investigations over a
+ * unix domain socket
+ */
+#define SERVE_OPTION "--serve"
+
+/**
+ * @def BATCH_OPTION- the option that analyses many meetings' files against the same people
+ */
+#define BATCH_OPTION "--batch"
+
+/**
+ * @def THREADS_OPTION- the option that sets the number of worker threads, followed by the number
+ */
+#define THREADS_OPTION "--threads"
+
+/**
+ * @def BATCH_OUTPUT_FILE- the output file of a single meetings' file in batch mode (the output
+ * file's name, followed by the meetings' file position in argv[], starting from 1)
+ */
+#define BATCH_OUTPUT_FILE OUTPUT_FILE ".%d"
+
+/**
+ * @def BATCH_OUTPUT_LENGTH- the maximal length of the output file's name in batch mode
+ */
+#define BATCH_OUTPUT_LENGTH 256
+
+/**
+ * @def MULTI_SOURCE_OPTION- the option that analyses many sick people (all the ids in the first
+ * line of the meetings' file) in a single pass over the meetings
+ */
+#define MULTI_SOURCE_OPTION "--multi-source"
+
+/**
+ * @def MAX_SOURCES- the maximal amount of sick people in multi-source mode, one per bit of a mask
+ */
+#define MAX_SOURCES 64
+
+/**
+ * @def SOURCES_LINE_LENGTH- the maximal length of the first line of the meetings' file in
+ * multi-source mode (MAX_SOURCES ids of up to 20 digits each)
+ */
+#define SOURCES_LINE_LENGTH 2048
+
+/**
+ * @def PRUNE_OPTION- the option that stops propagating probabilities that can't reach any threshold
+ */
+#define PRUNE_OPTION "--prune"
+
+/**
+ * @def NO_ROW- a RowIndex that isn't a row: an empty slot in the live set, or an id that wasn't
+ * found
+ */
+#define NO_ROW UINT32_MAX
+
+/**
+ * @def MAX_PEOPLE- the maximal amount of people, so every row is a RowIndex below NO_ROW
+ */
+#define MAX_PEOPLE ((size_t) NO_ROW)
+
+/**
+ * @def LIVE_SET_CAPACITY- the initial capacity of the live set (a power of 2)
+ */
+#define LIVE_SET_CAPACITY 64
+
+/**
+ * @def HASH_MULTIPLIER- the multiplier of the live set's hash (2^64 divided by the golden ratio)
+ */
+#define HASH_MULTIPLIER 11400714819323198485ull
+
+/**
+ * @def STATS_OPTION- the option that prints a report of the time and the work of every phase
+ */
+#define STATS_OPTION "--stats"
+
+/**
+ * @def PIPELINE_OPTION- the option that reads, parses and propagates the meetings on separate
+ * threads, connected by lock-free rings
+ */
+#define PIPELINE_OPTION "--pipeline"
+
+/**
+ * @def PIPELINE_BLOCK- the amount of bytes the reader thread reads into every block of meetings
+ */
+#define PIPELINE_BLOCK (1 << 20)
+
+/**
+ * @def RING_CAPACITY- the amount of blocks in a ring between two threads of the pipeline (a power
+ * of 2), which bounds the memory of the pipeline
+ */
+#define RING_CAPACITY 8
+
+/**
+ * @def CACHE_LINE- the size of a cache line, so the two ends of a ring don't share one
+ */
+#define CACHE_LINE 64
+
+/**
+ * @def PIPELINE_RESERVED_THREADS- the threads of the pipeline that don't parse (the reader and the
+ * propagation)
+ */
+#define PIPELINE_RESERVED_THREADS 2
+
+/**
+ * @def OVERLAP_OPTION- the option that tokenizes the meetings on another thread while the people
+ * are read and sorted
+ */
+#define OVERLAP_OPTION "--overlap"
+
+/**
+ * @def ALERTS_OPTION- the option that writes an alert whenever a person's classification changes
+ * while the meetings are applied
+ */
+#define ALERTS_OPTION "--alerts"
+
+/**
+ * @def ALERTS_STDOUT- the alerts' path that writes the alerts to the standard output
+ */
+#define ALERTS_STDOUT "-"
+
+/**
+ * @def ALERT_FORMAT- an alert: the microseconds since the alerts were opened, the meeting that
+ * changed the classification (0 for the sick person), the id and the name of the person, the
+ * previous and the new classification and the probability
+ */
+#define ALERT_FORMAT "ALERT %.0f %llu %lu %s %s %s %.6f\n"
+
+/**
+ * @def CHECKPOINT_OPTION- the option that keeps the probabilities between runs, so only the
+ * meetings appended to the meetings' file since the last run are applied
+ */
+#define CHECKPOINT_OPTION "--checkpoint"
+
+/**
+ * @def CHECKPOINT_MISMATCH_MSG- the massage to print when the checkpoint isn't of these files
+ */
+#define CHECKPOINT_MISMATCH_MSG "The checkpoint doesn't match the input files, " \
+								"recomputing from the start.\n"
+
+/**
+ * @def TEMP_FILE_SUFFIX- the suffix of the file a checkpoint or the classifications are written to,
+ * before it's renamed over the previous one
+ */
+#define TEMP_FILE_SUFFIX ".tmp"
+
+/**
+ * @def DELTA_OPTION- the option that writes only the people whose classification changed since the
+ * last run
+ */
+#define DELTA_OPTION "--delta"
+
+/**
+ * @def CLASSES_MISMATCH_MSG- the massage to print when the classifications aren't of the people's
+ * file
+ */
+#define CLASSES_MISMATCH_MSG "The classifications don't match the people's file, " \
+							 "writing all the people.\n"
+
+/**
+ * @def CACHE_OPTION- the option that keeps the output of every pair of input files in a directory,
+ * so the same investigation isn't computed twice
+ */
+#define CACHE_OPTION "--cache"
+
+/**
+ * @def CACHE_FILE_FORMAT- the path of a cached output: the directory, and the hashes of the people,
+ * of the meetings and of the parameters and the mode
+ */
+#define CACHE_FILE_FORMAT "%s/%016llx%016llx%016llx.out"
+
+/**
+ * @def CACHE_STORE_MSG- the massage to print when the output couldn't be cached (the run succeeds)
+ */
+#define CACHE_STORE_MSG "The output couldn't be cached.\n"
+
+/**
+ * @def CACHE_DIR_MODE- the permissions of a cache directory that doesn't exist yet
+ */
+#define CACHE_DIR_MODE 0777
+
+/**
+ * @def HASH_BLOCK- the amount of bytes read at once when a file is hashed
+ */
+#define HASH_BLOCK 65536
+
+/**
+ * @def HASH_PRIME1- a 64 bit prime that mixes every word into the hash of a file
+ */
+#define HASH_PRIME1 0x9E3779B185EBCA87ull
+
+/**
+ * @def HASH_PRIME2- another 64 bit prime that mixes every word into the hash of a file
+ */
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4Full
+
+/**
+ * @def HASH_ROTATION- the rotation of the hash after every word
+ */
+#define HASH_ROTATION 31
+
+/**
+ * @def EXTERNAL_OPTION- the option that sorts and resolves with files, within a memory budget
+ */
+#define EXTERNAL_OPTION "--external"
+
+/**
+ * @def MEMORY_OPTION- the option that sets the memory budget of external mode, in megabytes
+ */
+#define MEMORY_OPTION "--memory"
+
+/**
+ * @def EXTERNAL_DEFAULT_BUDGET- the default memory budget of external mode, in megabytes
+ */
+#define EXTERNAL_DEFAULT_BUDGET 64
+
+/**
+ * @def EXTERNAL_MIN_RECORDS- the minimal amount of records in a run, whatever the budget
+ */
+#define EXTERNAL_MIN_RECORDS 2
+
+/**
+ * @def EXTERNAL_OPEN_RUNS- the maximal amount of runs open at a time: a sorted half on every level
+ * of the recursion (a range of less than 2^64 records is halved less than 64 times), and the two
+ * runs of a merge with its merged run
+ */
+#define EXTERNAL_OPEN_RUNS 67
+
+/**
+ * @def EXTERNAL_OUTPUT_BLOCK- the amount of results read at once when the output is written, from
+ * the last one to the first
+ */
+#define EXTERNAL_OUTPUT_BLOCK 256
+
+/**
+ * @def PERF_OPTION- the option that prints the hardware counters of every phase
+ */
+#define PERF_OPTION "--perf"
+
+/**
+ * @def PERF_EVENTS- the amount of hardware counters: cycles, instructions, last level cache misses
+ * and branch misses
+ */
+#define PERF_EVENTS 4
+
+/**
+ * @def NO_COUNT- the value of a counter that isn't available
+ */
+#define NO_COUNT UINT64_MAX
+
+/**
+ * @def PERF_UNAVAILABLE_MSG- the massage to print when no hardware counter can be opened
+ */
+#define PERF_UNAVAILABLE_MSG "Hardware counters are not available, running without them.\n"
+
+/**
+ * @def TRACE_OPTION- the option that writes a timeline of the run to a trace file
+ */
+#define TRACE_OPTION "--trace"
+
+/**
+ * @def TRACE_CAPACITY- the initial amount of events in the trace buffer of a thread
+ */
+#define TRACE_CAPACITY 1024
+
+/**
+ * @def TRACE_CHUNK- the amount of rows in a traced chunk of meetings or of output, and the minimal
+ * length of a traced merge
+ */
+#define TRACE_CHUNK 65536
+
+/**
+ * @def NO_DETAIL- a trace event without a number
+ */
+#define NO_DETAIL -1
+
+/**
+ * @def MICROS_IN_SECOND- the amount of microseconds in a second
+ */
+#define MICROS_IN_SECOND 1000000.0
+
+/**
+ * @def NANOS_IN_SECOND- the amount of nanoseconds in a second
+ */
+#define NANOS_IN_SECOND 1000000000.0
+
+/**
+ * @def BYTES_IN_MEGABYTE- the amount of bytes in a megabyte
+ */
+#define BYTES_IN_MEGABYTE 1000000.0
+
+/**
+ * @def BYTES_IN_KILOBYTE- the amount of bytes in a kilobyte, as counted by getrusage()
+ */
+#define BYTES_IN_KILOBYTE 1024.0
+
+/**
+ * @def LISTEN_BACKLOG- the maximal amount of pending connections to the server's socket
+ */
+#define LISTEN_BACKLOG 16
+
+/**
+ * @def REQUEST_TIMEOUT_SECONDS- the time a client may take to send (or to read) the next part of a
+ * request, before the server drops it and moves on to the next client
+ */
+#define REQUEST_TIMEOUT_SECONDS 5
+
+/**
+ * @def REQUEST_FILE- the request that investigates a meetings' file, followed by the file's path
+ */
+#define REQUEST_FILE "FILE "
+
+/**
+ * @def REQUEST_INLINE- the request that investigates the meetings sent right after it
+ */
+#define REQUEST_INLINE "INLINE"
+
+/**
+ * @def REQUEST_END- the line that ends the inline meetings of a request
+ */
+#define REQUEST_END "END"
+
+/**
+ * @def REQUEST_ERROR- the response to a request that can't be investigated
+ */
+#define REQUEST_ERROR "ERROR %s\n"
+
+/**
+ * @def NOT_FOUND- the row returned when an id doesn't exist in the people's array
+ */
+#define NOT_FOUND NO_ROW
+
+/**
+ * @def LINE_END- the characters that may end a line in the files
+ */
+#define LINE_END "\r\n"
+
+/**
+ * @def PEOPLE_FILE_INDEX- the people's file index in argv[]
+ */
+#define PEOPLE_FILE_INDEX 1
+
+/**
+ * @def MEETINGS_FILE_INDEX- the meetings' file index in argv[]
+ */
+#define MEETINGS_FILE_INDEX 2
+
+/**
+ * @def STDIN_PATH- the meetings' path that reads the meetings from the standard input
+ */
+#define STDIN_PATH "-"
+
+/**
+ * @def SEPARATOR- the character that separates the fields in each line in the files
+ */
+#define SEPARATOR " "
+
+/**
+ * @def ALLOC_SIZE- the default size of  memory allocation
+ */
+#define ALLOC_SIZE 2
+
+/**
+ * @def DECIMAL_BASE- a numeric base for the int convertion
+ */
+#define DECIMAL_BASE 10
+
+/**
+ * @def EPSILON- the accuracy for float comparision
+ */
+#define EPSILON 0.000000001
+
+/**
+ * @def EQUAL- the objects are equal
+ */
+#define EQUAL 0
+
+/**
+ * @def GREATER- the first object greater than the second one
+ */
+#define GREATER 1
+
+/**
+ * @def SMALLER- the first object smaller than the second one
+ */
+#define SMALLER -1
+
+/**
+ * @def USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define USAGE_ERROR "USAGE: ./SpreaderDetectorBackend [--stats] [--perf] " \
+					"[--trace <Path to trace.json>] " \
+					"[--binary | --prune | --overlap | --pipeline [--threads <N>]] " \
+					"<Path to People.in> <Path to Meetings.in | ->\n" \
+					"       ./SpreaderDetectorBackend [--stats] [--alerts <Path to alerts | ->] " \
+					"[--checkpoint <Path to checkpoint>] [--delta <Path to classes>] " \
+					"<Path to People.in> <Path to Meetings.in | ->\n" \
+					"       ./SpreaderDetectorBackend [--stats] --cache <Path to directory> " \
+					"[--binary | --prune | --overlap | --pipeline] " \
+					"<Path to People.in> <Path to Meetings.in | ->\n" \
+					"       ./SpreaderDetectorBackend [--stats] --external [--memory <MB>] " \
+					"<Path to People.in> <Path to Meetings.in | ->\n" \
+					"       ./SpreaderDetectorBackend --convert [--compact] <Path to People.in> " \
+					"<Path to Meetings.in> <Path to Meetings.bin>\n" \
+					"       ./SpreaderDetectorBackend --serve <Path to People.in> " \
+					"<Path to socket>\n" \
+					"       ./SpreaderDetectorBackend --batch [--threads <N>] " \
+					"<Path to People.in> <Path to Meetings.in>...\n" \
+					"       ./SpreaderDetectorBackend --multi-source <Path to People.in> " \
+					"<Path to Meetings.in>\n"
+
+/**
+ * @def IN_FILE_ERROR- the massage to print when there is an error in the input files
+ */
+#define IN_FILE_ERROR "Error in input files.\n"
+
+/**
+ * @def OUT_FILE_ERROR- the massage to print when there is an error in opening the output file
+ */
+#define OUT_FILE_ERROR "Error in output file.\n"
+
+/**
+ * @def TOO_MANY_PEOPLE_ERROR- the massage to print when the people's file has more than MAX_PEOPLE
+ */
+#define TOO_MANY_PEOPLE_ERROR "Too many people.\n"
+
+/**
+ * @def MAX_LINE_LENGTH- the maximum length for each line in the file
+ */
+#define MAX_LINE_LENGTH 1024
+
+/**
+ * @def BINARY_MAGIC- the first 4 bytes of a binary meetings' file ("SDBM" in little endian)
+ */
+#define BINARY_MAGIC 0x4D424453u
+
+/**
+ * @def BINARY_VERSION- the version of the binary meetings' format
+ */
+#define BINARY_VERSION 1u
+
+/**
+ * @def BINARY_COMPACT_VERSION- the version of the compact binary meetings' format, whose meetings
+ * keep a quantized infection factor instead of the distance and the duration
+ */
+#define BINARY_COMPACT_VERSION 2u
+
+/**
+ * @def COMPACT_FACTOR_SCALE- the quantized factor of a meeting is crna() * COMPACT_FACTOR_SCALE,
+ * rounded, so the factors 0 and 1 are exact
+ */
+#define COMPACT_FACTOR_SCALE 65535.0f
+
+/**
+ * @def COMPACT_FACTOR_STEP- the factor of a single quantization step
+ */
+#define COMPACT_FACTOR_STEP (1.0f / COMPACT_FACTOR_SCALE)
+
+/**
+ * @def COMPACT_MAX_ERROR- the maximal error of a quantized factor: half a step, and the rounding of
+ * the floats. A probability that a chain of n meetings led to is off by at most
+ * n * COMPACT_MAX_ERROR
+ */
+#define COMPACT_MAX_ERROR 8e-6f
+
+/**
+ * @def NO_SICK_ROW- the sick row in a binary meetings' file that was converted from an empty file
+ */
+#define NO_SICK_ROW UINT32_MAX
+
+/**
+ * @def MEETINGS_CHUNK- the number of binary meeting records read or written in one call
+ */
+#define MEETINGS_CHUNK 4096
+
+/**
+ * @def CHECKPOINT_MAGIC- the first 4 bytes of a checkpoint ("SDCK" in little endian)
+ */
+#define CHECKPOINT_MAGIC 0x4B434453u
+
+/**
+ * @def CHECKPOINT_VERSION- the version of the checkpoint's format
+ */
+#define CHECKPOINT_VERSION 1u
+
+/**
+ * @def CHECKPOINT_TAIL- the amount of bytes before the checkpoint's offset in the meetings' file
+ * that are hashed, so a file that was rewritten (and not appended to) isn't resumed
+ */
+#define CHECKPOINT_TAIL 4096
+
+/**
+ * @def CLASSES_MAGIC- the first 4 bytes of a classifications' file ("SDCL" in little endian)
+ */
+#define CLASSES_MAGIC 0x4C434453u
+
+/**
+ * @def CLASSES_VERSION- the version of the classifications' format
+ */
+#define CLASSES_VERSION 1u
+
+/**
+ * @def UNKNOWN_CLASS- the previous classification of a person when there are no classifications of
+ * the people's file, so every person is written
+ */
+#define UNKNOWN_CLASS UINT8_MAX
+
+/**
+ * @def CHECKSUM_BASIS- the FNV-1a offset basis, the start value of the people's checksum
+ */
+#define CHECKSUM_BASIS 14695981039346656037ull
+
+/**
+ * @def CHECKSUM_PRIME- the FNV-1a prime, used to mix every id into the people's checksum
+ */
+#define CHECKSUM_PRIME 1099511628211ull
+
+/**
+ * @def Person- a struct that contains information about a person: name (dinamically allocates array
+ * of chars), id, age and the probability to get infected
+ */
+typedef struct Person
+{
+	char *name;
+	unsigned long int id;
+	float age;
+	float probability;
+} Person;
+
+/**
+ * @def RowIndex- the row of a person in the people's array sorted by id. Once the array is sorted,
+ * the ids are only needed to find rows, so meetings, indexes and sets keep these dense 32 bits
+ * instead of the 64 bits ids
+ */
+typedef uint32_t RowIndex;
+
+/**
+ * @def MeetingRecord- a struct that contains a single meeting after its ids were resolved to row
+ * indices in the people's array (sorted by id): the infector's row, the infected's row, the
+ * distance and the duration of the meeting. This is also the fixed-width record of the binary
+ * meetings' file
+ */
+typedef struct MeetingRecord
+{
+	RowIndex infectorRow;
+	RowIndex infectedRow;
+	float distance;
+	float time;
+} MeetingRecord;
+
+/**
+ * @def BinaryHeader- the header of a binary meetings' file. The rows in the file are only valid
+ * against the people's file they were resolved with, so the header keeps its size and checksum.
+ * All the fields are in the machine's native byte order
+ */
+typedef struct BinaryHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t peopleCount;
+	uint64_t peopleChecksum;
+	uint64_t meetingsCount;
+	RowIndex sickRow;
+	uint32_t reserved;
+} BinaryHeader;
+
+/**
+ * @def CompactChunk- a chunk of meetings in the compact binary format: the rows of every meeting
+ * (the infector's and then the infected's), followed by the quantized factor of every meeting, 10
+ * bytes a meeting. Every chunk but the last has MEETINGS_CHUNK meetings, and only the meetings in
+ * the chunk are written
+ */
+typedef struct CompactChunk
+{
+	RowIndex rows[2 * MEETINGS_CHUNK];
+	uint16_t factors[MEETINGS_CHUNK];
+} CompactChunk;
+
+/**
+ * @def CheckpointHeader- the header of a checkpoint, followed by the probability of every row. The
+ * probabilities are only valid against the people's file they were computed with, and the meetings'
+ * file they were computed from, up to the offset. All the fields are in the machine's native byte
+ * order
+ */
+typedef struct CheckpointHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t peopleCount;
+	uint64_t peopleChecksum;
+	uint64_t meetingsOffset;
+	uint64_t meetingsTailHash;
+	uint64_t meetingsApplied;
+} CheckpointHeader;
+
+/**
+ * @def ClassesHeader- the header of a classifications' file, followed by the classification of
+ * every row (a byte each). All the fields are in the machine's native byte order
+ */
+typedef struct ClassesHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t peopleCount;
+	uint64_t peopleChecksum;
+} ClassesHeader;
+
+/**
+ * @def Config- a struct that contains the run's options, as parsed from argv[]
+ */
+typedef struct Config
+{
+	int binaryMeetings;
+	int convert;
+	int compact;
+	int serve;
+	int batch;
+	int threads;
+	int multiSource;
+	int prune;
+	int pipeline;
+	int overlap;
+	int stats;
+	int perf;
+	const char *tracePath;
+	const char *alertsPath;
+	const char *checkpointPath;
+	const char *deltaPath;
+	const char *cacheDir;
+	int external;
+	size_t memoryBudget;
+	int firstArg;
+	int argsAmount;
+} Config;
+
+/**
+ * @def Investigation- a struct that contains the state of a single investigation in server mode.
+ * The probabilities are kept in the resident people's array, so the rows that were touched are
+ * remembered and reset at the end, and the investigation never costs more than its meetings
+ */
+typedef struct Investigation
+{
+	RowIndex *touched;
+	size_t touchedCount;
+	size_t touchedCapacity;
+	unsigned char *marks;
+} Investigation;
+
+/**
+ * @def Classification- the medical conclusion for a person, by its probability of infection
+ */
+typedef enum Classification
+{
+	CLEAN,
+	QUARANTINE,
+	HOSPITALIZATION
+} Classification;
+
+/**
+ * @def LiveSet- an open addressing hash table (with linear probing) from ids to rows, that contains
+ * the people whose probability may still reach a threshold. The probabilities of all the other
+ * people are 0
+ */
+typedef struct LiveSet
+{
+	unsigned long int *ids;
+	RowIndex *rows;
+	size_t capacity;
+	size_t count;
+} LiveSet;
+
+/**
+ * @def Phase- the phases of a run, as measured in stats mode
+ */
+typedef enum Phase
+{
+	PHASE_READ_PEOPLE,
+	PHASE_SORT_BY_ID,
+	PHASE_READ_MEETINGS,
+	PHASE_SORT_BY_PROBABILITY,
+	PHASE_WRITE_OUTPUT,
+	PHASE_BATCH,
+	PHASE_AMOUNT
+} Phase;
+
+/**
+ * @def MemorySubsystem- the parts of the program whose memory is accounted in stats mode
+ */
+typedef enum MemorySubsystem
+{
+	MEMORY_PEOPLE,
+	MEMORY_NAMES,
+	MEMORY_SORT,
+	MEMORY_PROPAGATION,
+	MEMORY_INDEX,
+	MEMORY_PIPELINE,
+	MEMORY_CLASSES,
+	MEMORY_AMOUNT
+} MemorySubsystem;
+
+/**
+ * @def MemoryUsage- a struct that contains the allocations of a single subsystem: the amount of
+ * allocations (and reallocations), the bytes allocated by them, the bytes still allocated and the
+ * high-water mark of those
+ */
+typedef struct MemoryUsage
+{
+	uint64_t calls;
+	uint64_t bytes;
+	uint64_t live;
+	uint64_t peak;
+} MemoryUsage;
+
+/**
+ * @def Stats- a struct that contains the measurements of a run. The counters are always updated
+ * (once per phase or per job, not per line), but the clock is only read in stats mode
+ */
+typedef struct Stats
+{
+	int enabled;
+	double phaseStart[PHASE_AMOUNT];
+	double phaseSeconds[PHASE_AMOUNT];
+	uint64_t phaseRows[PHASE_AMOUNT];
+	uint64_t phaseBytes[PHASE_AMOUNT];
+	uint64_t phaseStartBytes[PHASE_AMOUNT];
+	int phaseRan[PHASE_AMOUNT];
+	uint64_t rowsParsed;
+	uint64_t meetingsApplied;
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+	uint64_t lookups;
+	uint64_t allocations;
+	MemoryUsage memory[MEMORY_AMOUNT];
+	uint64_t memoryLive;
+	uint64_t memoryPeak;
+} Stats;
+
+/**
+ * The measurements of the run
+ */
+extern Stats stats;
+
+/**
+ * @def PerfCounters- a struct that contains the hardware counters of every phase. Every counter is
+ * opened on its own (not as a group), so a counter the machine doesn't have is the only one
+ * missing, and it's inherited by the threads created after it's opened
+ */
+typedef struct PerfCounters
+{
+	int enabled;
+	int fds[PERF_EVENTS];
+	uint64_t start[PHASE_AMOUNT][PERF_EVENTS];
+	uint64_t values[PHASE_AMOUNT][PERF_EVENTS];
+	int ran[PHASE_AMOUNT];
+} PerfCounters;
+
+/**
+ * The hardware counters of the run
+ */
+extern PerfCounters perf;
+
+/**
+ * @def TraceEvent- a single span of the timeline, in seconds of the monotonic clock
+ */
+typedef struct TraceEvent
+{
+	const char *name;
+	const char *category;
+	double start;
+	double end;
+	long detail;
+} TraceEvent;
+
+/**
+ * @def TraceBuffer- the events of a single thread. Only the thread itself writes to its buffer, so
+ * recording an event takes no lock, and the buffers are only read after all the threads are joined
+ */
+typedef struct TraceBuffer
+{
+	TraceEvent *events;
+	int count;
+	int capacity;
+	int thread;
+	uint64_t dropped;
+	struct TraceBuffer *next;
+} TraceBuffer;
+
+/**
+ * @def Tracer- a struct that contains the state of trace mode. The buffers are pushed to the list
+ * by a compare-and-swap when a thread records its first event
+ */
+typedef struct Tracer
+{
+	int enabled;
+	const char *path;
+	TraceBuffer *buffers;
+	int threads;
+} Tracer;
+
+/**
+ * The timeline of the run
+ */
+extern Tracer tracer;
+
+/**
+ * @def Alerter- a struct that contains the state of the alerts: the last classification of every
+ * row (so only a change is alerted), and the latency of writing the alerts, from the moment the
+ * change is detected until the alert is flushed
+ */
+typedef struct Alerter
+{
+	FILE *file;
+	unsigned char *classes;
+	size_t classesCount;
+	double start;
+	uint64_t alerts;
+	double latencySum;
+	double latencyMax;
+} Alerter;
+
+/**
+ * The alerts of the run
+ */
+extern Alerter alerter;
+
+/**
+ * @def BatchPool- a struct that contains the state shared by the worker threads in batch mode.
+ * The people's array is only read by the workers, every job keeps its own probabilities
+ */
+typedef struct BatchPool
+{
+	Person *peopleList;
+	size_t peopleListSize;
+	char **meetingsPaths;
+	int jobsAmount;
+	int nextJob;
+	int failures;
+	pthread_mutex_t lock;
+} BatchPool;
+
+/**
+ * @def BlockStatus- the kind of a block of meetings in the pipeline
+ */
+typedef enum BlockStatus
+{
+	BLOCK_DATA,
+	BLOCK_END,
+	BLOCK_ERROR
+} BlockStatus;
+
+/**
+ * @def MeetingsBlock- a block of whole lines of the meetings' file. The reader fills its text, a
+ * parser turns the text into records, and the propagation applies the records
+ */
+typedef struct MeetingsBlock
+{
+	BlockStatus status;
+	char *text;
+	size_t length;
+	MeetingRecord *records;
+	int recordsCount;
+} MeetingsBlock;
+
+/**
+ * @def SpscRing- a bounded ring of blocks between a single producer and a single consumer. The
+ * producer only writes the tail and the consumer only writes the head, so it needs no lock
+ */
+typedef struct SpscRing
+{
+	MeetingsBlock *slots[RING_CAPACITY];
+	uint64_t head;
+	char headPadding[CACHE_LINE - sizeof(uint64_t)];
+	uint64_t tail;
+	char tailPadding[CACHE_LINE - sizeof(uint64_t)];
+} SpscRing;
+
+/**
+ * @def Pipeline- a struct that contains the state shared by the threads of the pipeline. Block k
+ * goes through parser k % parsers, on rings of its own in both directions, so the propagation gets
+ * the blocks in the file's order by taking them from the parsers in turn
+ */
+typedef struct Pipeline
+{
+	FILE *meetingsFile;
+	Person *peopleList;
+	size_t peopleListSize;
+	size_t blockSize;
+	int parsers;
+	SpscRing *toParsers;
+	SpscRing *toPropagation;
+	int stopped;
+	uint64_t bytesRead;
+} Pipeline;
+
+/**
+ * @def ParserTask- the argument of a parser thread
+ */
+typedef struct ParserTask
+{
+	Pipeline *pipeline;
+	int index;
+} ParserTask;
+
+/**
+ * @def RawMeeting- a meeting as it is in the file, before its ids are resolved to rows
+ */
+typedef struct RawMeeting
+{
+	unsigned long int infectorId;
+	unsigned long int infectedId;
+	float distance;
+	float time;
+} RawMeeting;
+
+/**
+ * @def recordCompare- a comparison of two fixed size records, as qsort() takes
+ */
+typedef int (*recordCompare)(const void *a, const void *b);
+
+/**
+ * @def ExternalPerson- a person in external mode: the id, and the offset of the person's line in
+ * the people's file, where the name is read from when the output is written
+ */
+typedef struct ExternalPerson
+{
+	uint64_t id;
+	uint64_t offset;
+} ExternalPerson;
+
+/**
+ * @def ExternalMeeting- a meeting in external mode. The infector and the infected are ids, until
+ * they are resolved to rows by joining the meetings with the people
+ */
+typedef struct ExternalMeeting
+{
+	uint64_t sequence;
+	uint64_t infector;
+	uint64_t infected;
+	float distance;
+	float time;
+} ExternalMeeting;
+
+/**
+ * @def ExternalResult- a person's line of the output in external mode, before it's sorted
+ */
+typedef struct ExternalResult
+{
+	uint64_t id;
+	uint64_t offset;
+	float probability;
+	uint32_t reserved;
+} ExternalResult;
+
+/**
+ * @def MeetingsTokenizer- a struct that contains the meetings tokenized by another thread
+ */
+typedef struct MeetingsTokenizer
+{
+	FILE *meetingsFile;
+	pthread_t thread;
+	int empty;
+	unsigned long int sickId;
+	RawMeeting *meetings;
+	size_t meetingsAmount;
+	size_t capacity;
+	const char *error;
+	uint64_t bytesRead;
+} MeetingsTokenizer;
+
+/**
+ * @def compFunc- a typdef to a function that compares two persons
+ */
+typedef int (*compFunc)(const Person, const Person);
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function is responsible to free the array of Person's structs, including the name field in
+ * each struct
+ * @param peopleList - the array of structs
+ * @param length - the length of the array
+ */
+void freePeople(Person *peopleList, size_t length);
+
+/**
+ * This function is doing the required actions before exiting the program with EXIT_FAILURE code.
+ * @param fileToClose - a pointer to the file needed to be closed. NULL if there isn't any open file
+ * @param errorToPrint - the error needed to be print to the stderr
+ * @param peopleList - the array of Persons needed to be freed. NULL if the array doesn't exist
+ * @param peopleListSize - the size of the array
+ */
+void beforeExitFailure(FILE *fileToClose, const char *errorToPrint, Person *peopleList,
+					   size_t peopleListSize);
+
+/**
+ * This function checks if the amount of arguments is ok
+ * @param argc - the amount of arguments in the program (not including the options)
+ * @param expected - the amount of arguments required by the chosen mode
+ * @return - 1 if succeeded, 0 if failed
+ */
+int argcCheck(int argc, int expected);
+
+/**
+ * This function parses the options at the beginning of argv[] and checks the amount of the
+ * remaining arguments
+ * @param argc - the amount of arguments in the program
+ * @param argv - the arguments of the program
+ * @param config - the struct to fill
+ * @return - 1 if succeeded, 0 if failed
+ */
+int parseArguments(int argc, char *argv[], Config *config);
+
+/**
+ * This function calculates the probability for infection between two people
+ * @param dist - the distance between them in their meeting (float)
+ * @param time - the duration of their meeting (float)
+ * @return a float with the probability
+ */
+float crna(float dist, float time);
+
+/**
+ * This function compares between two persons' id
+ * @param a - the first Person
+ * @param b - the second Person
+ * @return - 1 if a is greater, -1 if a is smaller, 0 if a and b are equal
+ */
+int idCompare(Person a, Person b);
+
+/**
+ * This function compares between two probabilities of infection
+ * @param a - the first probability
+ * @param b - the second probability
+ * @return - 1 if a is greater, -1 if a is smaller, 0 if a and b are equal
+ */
+int compareProbabilities(float a, float b);
+
+/**
+ * This function compares between two persons' probability of infection
+ * @param a - the first Person
+ * @param b - the second Person
+ * @return - 1 if a is greater, -1 if a is smaller, 0 if a and b are equal
+ */
+int probCompare(Person a, Person b);
+
+/**
+ * Merges two sorted sub-arrays into one sorted array
+ * @param peopleList - the main array to sort
+ * @param a - a pointer to the first sub-array
+ * @param aLen - the length of the first sub-array
+ * @param b - a pointer to the second sub-array
+ * @param bLen - the length of the second sub-array
+ * @param start - the index (in the original list) to start with
+ * @param comp - a compare function
+ */
+void merge(Person *peopleList, Person *a, size_t aLen, Person *b, size_t bLen, size_t start,
+		   compFunc comp);
+
+/**
+ * Sorts the people's list, using the Merge-Sort algorithm
+ * @param peopleList - the main array to sort
+ * @param draftList - an array of structs (type Person)
+ * @param length - an int with the length of the array
+ * @param start - an int with the index to start with (in the original list)
+ * @param comp - a compare function
+ */
+void mergeSort(Person *peopleList, Person *draftList, size_t length, size_t start, compFunc comp);
+
+/**
+ * Sorts the people's list by id, using the same Merge-Sort as mergeSort() with idCompare(), but
+ * with the ids compared in the merge itself
+ * @param peopleList - the main array to sort
+ * @param draftList - an array of structs (type Person)
+ * @param length - an int with the length of the array
+ * @param start - an int with the index to start with (in the original list)
+ */
+void mergeSortById(Person *peopleList, Person *draftList, size_t length, size_t start);
+
+/**
+ * Sorts an array of rows by their probabilities, using the same Merge-Sort as mergeSort(), so the
+ * ties are in the same order
+ * @param rows - the array of rows to sort
+ * @param draftRows - a draft array of rows, as long as the array to sort
+ * @param length - an int with the length of the array
+ * @param start - an int with the index to start with (in the original array)
+ * @param probabilities - the probabilities of the rows
+ */
+void mergeSortRows(RowIndex *rows, RowIndex *draftRows, size_t length, size_t start,
+				   const float *probabilities);
+
+/**
+ * This function sorts an array of struct Person by the id attribute
+ * @param peopleList - the array to sort
+ * @param peopleListSize - the length of the array
+ * @return nothing, if fails- frees all memory and exits the program
+ */
+void sortById(Person **peopleList, size_t peopleListSize);
+
+/**
+ * This function sorts an array of struct Person by the probability attribute
+ * @param peopleList - the array to sort
+ * @param peopleListSize - the length of the array
+ * @return nothing, if fails- frees all memory and exits the program
+ */
+void sortByProbability(Person **peopleList, size_t peopleListSize);
+
+/**
+ * This function gets an empty struct of type Person and a line with information, and fills the
+ * struct's fields
+ * @param line - a string with the information from the file
+ * @param person - the struct to fill
+ * @return 1 if succeeded, 0 if failed
+ */
+int fillPerson(char *line, Person *person);
+
+/**
+ * This function reads the people's file and put the data in an array of struct Person
+ * @param peopleFile - pointer to the people's file
+ * @param peopleList - type Person**, a pointer to the array to fill
+ * @return the number of people in the file (and in the array). if fails- frees all memory and
+ * exits the program
+ */
+size_t readPeopleFile(FILE *peopleFile, Person **peopleList);
+
+/**
+ * This function allocates more memory to the array of struct Person, using realloc
+ * @param peopleList - the array of struct Person
+ * @param capacity - the new size for the array
+ * @param counter - the current size of the array
+ * @param peopleFile - a pointer to the people's file
+ */
+void allocateMore(Person **peopleList, size_t capacity, size_t counter, FILE *peopleFile);
+
+/**
+ * This function opens the meetings' file. STDIN_PATH is the standard input, so the meetings can be
+ * streamed by another program; a FIFO is opened like a file. The meetings are read line by line (or
+ * block by block), so a stream never has to be kept in memory or on disk
+ * @param path - the path of the meetings' file, or STDIN_PATH
+ * @param mode - the mode to open it in
+ * @return the file, NULL if failed
+ */
+FILE *openMeetingsFile(const char *path, const char *mode);
+
+/**
+ * This function applies the meetings from the current position of the meetings' file to its end
+ * @param meetingsFile - the meetings' file, after the sick person's line
+ * @param peopleList - the array to update
+ * @param peopleListSize - the size of the array
+ * @param applied - the amount of meetings applied before, that the meetings are numbered from
+ * @param wholeLines - whether to stop before a last line without its line end, and leave the file
+ * at its start
+ * @return the amount of meetings applied, including the ones before
+ */
+uint64_t applyMeetings(FILE *meetingsFile, Person *peopleList, size_t peopleListSize,
+					   uint64_t applied, int wholeLines);
+
+/**
+ * This function hashes the bytes of the meetings' file before an offset (up to CHECKPOINT_TAIL of
+ * them), and leaves the file at the offset
+ * @param meetingsFile - the meetings' file
+ * @param offset - the offset
+ * @param hash - the hash, set by the function
+ * @return 1 if succeeded, 0 if the file is shorter or can't be read
+ */
+int meetingsTailHash(FILE *meetingsFile, uint64_t offset, uint64_t *hash);
+
+/**
+ * This function opens a temporary file next to a path, to replace the file at the path once it's
+ * written completely
+ * @param path - the path to replace
+ * @param tempPath - the path of the temporary file, set by the function and freed by
+ * replaceFile()
+ * @return the temporary file, NULL if failed
+ */
+FILE *openReplacement(const char *path, char **tempPath);
+
+/**
+ * This function closes a temporary file, and renames it over the path if it was written completely
+ * @param file - the temporary file, NULL if it wasn't opened
+ * @param tempPath - the path of the temporary file, freed by the function
+ * @param path - the path to replace
+ * @param written - whether the file was written completely
+ * @return 1 if the path was replaced, 0 if not
+ */
+int replaceFile(FILE *file, char *tempPath, const char *path, int written);
+
+/**
+ * This function loads the checkpoint of the last run, if it's of these files: the probabilities are
+ * set, and the meetings' file is moved to where the last run stopped
+ * @param path - the path of the checkpoint
+ * @param meetingsFile - the meetings' file
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param header - the header of the checkpoint, set by the function
+ * @return 1 if loaded, 0 if there's no checkpoint of these files (the probabilities and the file
+ * are untouched)
+ */
+int loadCheckpoint(const char *path, FILE *meetingsFile, Person *peopleList, size_t peopleListSize,
+				   CheckpointHeader *header);
+
+/**
+ * This function writes the checkpoint of this run, to a temporary file that is renamed over the
+ * previous checkpoint, so a run that fails keeps the previous one
+ * @param path - the path of the checkpoint
+ * @param meetingsFile - the meetings' file, at its end
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param applied - the amount of meetings applied
+ * @return 1 if succeeded, 0 if failed
+ */
+int saveCheckpoint(const char *path, FILE *meetingsFile, Person *peopleList, size_t peopleListSize,
+				   uint64_t applied);
+
+/**
+ * This function reads the data from the meetings' file and accordingly updates the array of
+ * Persons, like readMeetingsFile(), but resumes from the checkpoint of the last run when there is
+ * one: a meeting only sets the probability of its infected person from the current probability of
+ * its infector, so applying the appended meetings to the kept probabilities is the same as
+ * applying the whole file again. The checkpoint is then updated, up to the last line end: a last
+ * line without one may be a meeting that is still being appended
+ * @param meetingsFile - the meetings' file (seekable), closed at the end
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param checkpointPath - the path of the checkpoint
+ */
+void readMeetingsFileIncremental(FILE *meetingsFile, Person *peopleList, size_t peopleListSize,
+								 const char *checkpointPath);
+
+/**
+ * This function loads the classifications of the last run
+ * @param path - the path of the classifications' file
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param classes - an array of a classification per row to fill: CLEAN for everybody on the first
+ * run, UNKNOWN_CLASS for everybody if the file isn't of the people's file
+ */
+void loadClasses(const char *path, Person *peopleList, size_t peopleListSize,
+				 unsigned char *classes);
+
+/**
+ * This function writes the classifications of this run
+ * @param path - the path of the classifications' file
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param classes - the classification of every row
+ * @return 1 if succeeded, 0 if failed
+ */
+int saveClasses(const char *path, Person *peopleList, size_t peopleListSize,
+				const unsigned char *classes);
+
+/**
+ * This function writes to the output file only the people whose classification changed since the
+ * last run (in the output's format, by id), and keeps the classifications for the next run. The
+ * array doesn't have to be sorted by probability
+ * @param outputFile - the output file, closed at the end
+ * @param classesPath - the path of the classifications' file
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return the amount of people written. if fails- frees all memory and exits the program
+ */
+size_t writeDeltaOutput(FILE *outputFile, const char *classesPath, Person *peopleList,
+						size_t peopleListSize);
+
+/**
+ * This function mixes a word into a hash
+ * @param hash - the hash
+ * @param word - the word
+ * @return the new hash
+ */
+uint64_t hashMix(uint64_t hash, uint64_t word);
+
+/**
+ * This function hashes the content of a file (a fast streaming hash, not a cryptographic one)
+ * @param path - the path of the file
+ * @param hash - the hash, set by the function
+ * @return 1 if succeeded, 0 if the file can't be read
+ */
+int hashFile(const char *path, uint64_t *hash);
+
+/**
+ * This function hashes the parameters of SpreaderDetectorParams.h and the options of the run that
+ * change its output (--binary and --prune), so a cached output is used by every run that would
+ * write the same output
+ * @param config - the options of the run
+ * @return the hash
+ */
+uint64_t paramsHash(const Config *config);
+
+/**
+ * This function finds the path of the cached output of the input files
+ * @param cacheDir - the cache's directory, created if it doesn't exist
+ * @param peoplePath - the people's file
+ * @param meetingsPath - the meetings' file
+ * @param config - the options of the run
+ * @return the path (freed by the caller), NULL if an input file can't be read
+ */
+char *cachedOutputPath(const char *cacheDir, const char *peoplePath, const char *meetingsPath,
+					   const Config *config);
+
+/**
+ * This function copies a file
+ * @param from - the file to copy
+ * @param to - the copy, not closed
+ * @return 1 if succeeded, 0 if failed
+ */
+int copyFile(FILE *from, FILE *to);
+
+/**
+ * This function writes the cached output to the output file, if there is one
+ * @param cachedPath - the path of the cached output
+ * @return 1 if the output was written, 0 if it isn't cached
+ */
+int restoreCachedOutput(const char *cachedPath);
+
+/**
+ * This function keeps the output file in the cache
+ * @param cachedPath - the path of the cached output
+ * @return 1 if succeeded, 0 if failed
+ */
+int storeCachedOutput(const char *cachedPath);
+
+/**
+ * This function compares the ids of two ExternalPersons
+ * @param a - the first person
+ * @param b - the second person
+ * @return a negative number, 0 or a positive number, as the first id is smaller, equal or greater
+ */
+int compareExternalIds(const void *a, const void *b);
+
+/**
+ * This function compares the infectors of two ExternalMeetings
+ * @param a - the first meeting
+ * @param b - the second meeting
+ * @return a negative number, 0 or a positive number, as the first infector is smaller, equal or
+ * greater
+ */
+int compareInfectors(const void *a, const void *b);
+
+/**
+ * This function compares the infected people of two ExternalMeetings
+ * @param a - the first meeting
+ * @param b - the second meeting
+ * @return a negative number, 0 or a positive number, as the first infected is smaller, equal or
+ * greater
+ */
+int compareInfected(const void *a, const void *b);
+
+/**
+ * This function compares the places of two ExternalMeetings in the meetings' file
+ * @param a - the first meeting
+ * @param b - the second meeting
+ * @return a negative number, 0 or a positive number, as the first meeting is earlier, the same or
+ * later
+ */
+int compareSequences(const void *a, const void *b);
+
+/**
+ * This function compares the probabilities of two ExternalResults, as probCompare() does (equal up
+ * to EPSILON)
+ * @param a - the first result
+ * @param b - the second result
+ * @return a negative number, 0 or a positive number, as the first probability is smaller, equal or
+ * greater
+ */
+int compareResults(const void *a, const void *b);
+
+/**
+ * This function sorts fixed size records in memory, exactly as mergeSort() sorts people (the same
+ * halves, and a record of the second half goes first unless the first half's is smaller)
+ * @param records - the records
+ * @param draft - a draft array of the same length
+ * @param length - the amount of records
+ * @param recordSize - the size of a record
+ * @param compare - the order of the records
+ */
+void mergeSortRecords(char *records, char *draft, size_t length, size_t recordSize,
+					  recordCompare compare);
+
+/**
+ * This function merges two sorted runs of records into a single sorted run, as mergeSort() merges
+ * two halves
+ * @param a - the run of the first half, rewound, closed by the function
+ * @param b - the run of the second half, rewound, closed by the function
+ * @param recordSize - the size of a record
+ * @param compare - the order of the records
+ * @return the merged run, rewound, NULL if failed
+ */
+FILE *mergeRuns(FILE *a, FILE *b, size_t recordSize, recordCompare compare);
+
+/**
+ * This function sorts a range of records of a file into a run, as mergeSort() sorts a range: a
+ * range that fits in the buffer is sorted in memory, and a larger one is halved, both halves are
+ * sorted into runs, and the runs are merged
+ * @param input - the file of records
+ * @param start - the first record of the range
+ * @param length - the amount of records in the range
+ * @param recordSize - the size of a record
+ * @param compare - the order of the records
+ * @param buffer - a buffer of 2 * capacity records: the range and its draft
+ * @param capacity - the maximal amount of records sorted in memory
+ * @return the sorted run, rewound, NULL if failed
+ */
+FILE *sortRange(FILE *input, uint64_t start, uint64_t length, size_t recordSize,
+				recordCompare compare, char *buffer, size_t capacity);
+
+/**
+ * This function sorts a file of fixed size records within a memory budget, in the same order
+ * mergeSort() would sort them in memory (so the ties of a comparator that isn't transitive, as
+ * EPSILON's, are broken the same way). The budget holds a range and its draft, and what's left of
+ * it after the buffers of EXTERNAL_OPEN_RUNS open runs
+ * @param input - the file of records, closed by the function
+ * @param recordSize - the size of a record
+ * @param compare - the order of the records
+ * @param budget - the memory budget, in bytes
+ * @return the sorted file, rewound, NULL if failed
+ */
+FILE *externalSort(FILE *input, size_t recordSize, recordCompare compare, size_t budget);
+
+/**
+ * This function resolves an id of every meeting to a row, by a merge join of the meetings (sorted
+ * by that id) with the people (sorted by id)
+ * @param meetings - the meetings, sorted by the id to resolve, closed by the function
+ * @param people - the people, sorted by id
+ * @param infector - 1 to resolve the infectors, 0 to resolve the infected people
+ * @return the resolved meetings, rewound, NULL if failed (or an id isn't of a person)
+ */
+FILE *joinMeetings(FILE *meetings, FILE *people, int infector);
+
+/**
+ * This function finds the row of an id in the people, sorted by id, by a binary search in the file
+ * @param people - the people, sorted by id
+ * @param peopleCount - the amount of people
+ * @param id - the id
+ * @return the row, NOT_FOUND if there's no such person
+ */
+RowIndex findExternalRow(FILE *people, uint64_t peopleCount, uint64_t id);
+
+/**
+ * This function writes a record of every person in the people's file (the id and the offset of
+ * the line) to a temporary file
+ * @param peopleFile - the people's file
+ * @param peopleCount - the amount of people, set by the function (more than MAX_PEOPLE if the
+ * file has too many people)
+ * @return the file of records, NULL if failed
+ */
+FILE *spillPeople(FILE *peopleFile, uint64_t *peopleCount);
+
+/**
+ * This function writes a record of every meeting in the meetings' file to a temporary file, and
+ * sets the probability of the sick person
+ * @param meetingsFile - the meetings' file
+ * @param people - the people, sorted by id
+ * @param peopleCount - the amount of people
+ * @param probabilities - the probability of every row
+ * @param meetingsCount - the amount of meetings, set by the function
+ * @return the file of records, NULL if failed (or the sick person isn't of the people)
+ */
+FILE *spillMeetings(FILE *meetingsFile, FILE *people, uint64_t peopleCount, float *probabilities,
+					uint64_t *meetingsCount);
+
+/**
+ * This function writes the output's lines of the results, from the last one to the first (as
+ * writeOutput() writes the people sorted by probability), with the names read from the people's
+ * file
+ * @param results - the results, sorted by compareResults()
+ * @param peopleFile - the people's file
+ * @param outputFile - the output file
+ * @return 1 if succeeded, 0 if failed
+ */
+int writeExternalOutput(FILE *results, FILE *peopleFile, FILE *outputFile);
+
+/**
+ * This function runs the whole analysis within a memory budget: the people and the meetings are
+ * sorted by external merge sorts, and the meetings are resolved by merge joins with the people
+ * instead of a binary search per id. Only the probabilities (4 bytes per person) and the sorts'
+ * buffers are kept in memory
+ * @param peoplePath - the people's file
+ * @param meetingsPath - the meetings' file, or STDIN_PATH
+ * @param outputPath - the output file
+ * @param budget - the memory budget, in bytes
+ * @return EXIT_SUCCESS, or EXIT_FAILURE (the error is printed)
+ */
+int runExternal(const char *peoplePath, const char *meetingsPath, const char *outputPath,
+				size_t budget);
+
+/**
+ * This function reads the data from the meetings' file and accordingly updates the array of Persons
+ * @param meetingsFile - the meetings' file
+ * @param peopleList - the array to update
+ * @param peopleListSize - the size of the array
+ */
+void readMeetingsFile(FILE *meetingsFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function parses a line from the meetings' file and resolves its ids to rows in the array
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param line - a string with the line from the meetings' file
+ * @param meeting - the struct to fill
+ * @return 1 if succeeded, 0 if the line contains an unknown id
+ */
+int parseMeeting(Person *peopleList, size_t peopleListSize, char *line, MeetingRecord *meeting);
+
+/**
+ * This function calculates the probability for a certain Person (taken from a line) and updates it
+ * in its struct
+ * @param peopleList - the array of Persons
+ * @param peopleListSize - the size of the array
+ * @param line - a string with the line from the meetings' file
+ * @return the row of the infected person, NOT_FOUND if the line contains an unknown id (and then
+ * nobody is updated)
+ */
+RowIndex probUpdater(Person *peopleList, size_t peopleListSize, char *line);
+
+/**
+ * This function calculates a checksum of the ids in the array, so a binary meetings' file can be
+ * matched with the people's file its rows were resolved against
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return the checksum
+ */
+uint64_t peopleChecksum(Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function quantizes the infection factor of a meeting for the compact binary format. Factors
+ * outside [0, 1] (of meetings closer than MIN_DISTANCE, or longer than MAX_TIME) are clamped
+ * @param factor - the factor, as crna() computed it
+ * @return the amount of COMPACT_FACTOR_STEP in the factor
+ */
+uint16_t quantizeFactor(float factor);
+
+/**
+ * This function writes a chunk of meetings to a binary meetings' file
+ * @param binaryFile - the binary file to write to
+ * @param chunk - the meetings
+ * @param chunkSize - the amount of meetings
+ * @param compact - whether to write them in the compact format
+ * @return SUCCESS if they were written, FAILURE if not
+ */
+int writeMeetingsChunk(FILE *binaryFile, const MeetingRecord *chunk, size_t chunkSize,
+					   int compact);
+
+/**
+ * This function converts a text meetings' file to the binary format, resolving every id to its row
+ * in the array. It stops at the first unknown id. The meetings' file is closed at the end, and the
+ * binary file is left open for the caller, that drops it if the conversion failed
+ * @param meetingsFile - the text meetings' file
+ * @param binaryFile - the binary file to write to
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param compact - whether to convert to the compact format
+ * @return NULL if succeeded, the error message if not
+ */
+const char *convertMeetingsFile(FILE *meetingsFile, FILE *binaryFile, Person *peopleList,
+								size_t peopleListSize, int compact);
+
+/**
+ * This function applies the meeting records of a binary meetings' file, after its header
+ * @param binaryFile - the binary meetings' file
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return the amount of meetings applied
+ */
+uint64_t applyRecords(FILE *binaryFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function applies the chunks of a compact binary meetings' file, after its header
+ * @param binaryFile - the binary meetings' file
+ * @param meetingsCount - the amount of meetings in the file, as its header says
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return the amount of meetings applied
+ */
+uint64_t applyCompactChunks(FILE *binaryFile, uint64_t meetingsCount, Person *peopleList,
+							size_t peopleListSize);
+
+/**
+ * This function reads a binary meetings' file (of either format) and accordingly updates the array
+ * of Persons
+ * @param binaryFile - the binary meetings' file
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ */
+void readBinaryMeetingsFile(FILE *binaryFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function classifies a probability of infection by the thresholds
+ * @param probability - the probability of infection
+ * @return the medical conclusion
+ */
+Classification classify(float probability);
+
+/**
+ * This function writes the medical conclusion for a single person by its probability of infection
+ * @param outputFile - the file to write to
+ * @param person - the Person to write
+ * @param probability - the probability of infection
+ */
+void writePerson(FILE *outputFile, const Person *person, float probability);
+
+/**
+ * This function writes the medical conclusions for the people in the array by their probability of
+ * infection, without closing the file
+ * @param outputFile - the file to write to
+ * @param peopleList - the array of struct Person, sorted by probability
+ * @param peopleListSize - the size of the array
+ */
+void writePeople(FILE *outputFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function is responsible to write to the output file the medical conclusions for the people
+ * in the program by their probability of infection
+ * @param outputFile - the file to write to
+ * @param peopleList - the array of struct Person
+ * @param peopleListSize - the size of the array
+ */
+void writeOutput(FILE *outputFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function finds the row of an id in the array, which doesn't have to have it
+ * @param peopleList - the array to search in, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param idToFind - the id to search
+ * @return - the row of the id, NOT_FOUND if it isn't in the array
+ */
+RowIndex findRow(Person *peopleList, size_t peopleListSize, unsigned long int idToFind);
+
+/**
+ * This function parses a line from a meetings' file that wasn't checked in advance, and resolves
+ * its ids to rows in the array
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param line - a string with the line
+ * @param meeting - the struct to fill
+ * @return 1 if succeeded, 0 if the line is malformed or contains an unknown id
+ */
+int resolveMeeting(Person *peopleList, size_t peopleListSize, char *line, MeetingRecord *meeting);
+
+/**
+ * This function sets a probability in the resident array, and remembers the row so it can be
+ * reset at the end of the investigation
+ * @param investigation - the state of the investigation
+ * @param peopleList - the resident array of Persons
+ * @param row - the row to update
+ * @param probability - the new probability
+ * @return 1 if succeeded, 0 if failed
+ */
+int touchRow(Investigation *investigation, Person *peopleList, RowIndex row, float probability);
+
+/**
+ * This function reads the meetings of a single request (a sick id in the first line, then a meeting
+ * in every line, until the end of the file or an END line), and updates the resident array
+ * @param meetings - the file to read from
+ * @param investigation - the state of the investigation
+ * @param peopleList - the resident array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return NULL if succeeded, otherwise a string with the reason of the failure
+ */
+const char *investigate(FILE *meetings, Investigation *investigation, Person *peopleList,
+						size_t peopleListSize);
+
+/**
+ * This function writes the conclusions for the people touched by an investigation, in the same
+ * order as the output file, and resets their probabilities
+ * @param response - the file to write to, NULL to only reset the probabilities
+ * @param investigation - the state of the investigation
+ * @param peopleList - the resident array of Persons, sorted by id
+ * @return NULL if succeeded, otherwise a string with the reason of the failure
+ */
+const char *respond(FILE *response, Investigation *investigation, Person *peopleList);
+
+/**
+ * This function reads a single request from a client of the server and writes the response to it.
+ * A client that stalls for REQUEST_TIMEOUT_SECONDS gets an error, so it can't hold the server
+ * @param clientFd - the client's socket
+ * @param investigation - the state of the investigation
+ * @param peopleList - the resident array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ */
+void handleRequest(int clientFd, Investigation *investigation, Person *peopleList,
+				   size_t peopleListSize);
+
+/**
+ * This function removes the socket left at a path by a former server, and only a socket
+ * @param socketPath - the path of the socket
+ * @return 1 if there is nothing at the path now, 0 if there is something else than a socket
+ */
+int removeSocket(const char *socketPath);
+
+/**
+ * This function stops the server at the next request (a handler of SIGINT and SIGTERM)
+ * @param signum - the signal's number
+ */
+void stopServer(int signum);
+
+/**
+ * This function keeps the people in memory and serves investigations over a unix domain socket,
+ * until it gets SIGINT or SIGTERM
+ * @param socketPath - the path of the socket to listen on
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+int serve(const char *socketPath, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function sorts the rows by their probabilities and writes the medical conclusions to a new
+ * output file, in the same order as writeOutput()
+ * @param outputPath - the path of the output file
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param probabilities - the probabilities of the rows
+ * @param rows - an array of peopleListSize rows, to sort
+ * @param draftRows - a draft array of peopleListSize rows
+ * @return NULL if succeeded, otherwise the error to print
+ */
+const char *writeRowsOutput(const char *outputPath, Person *peopleList, size_t peopleListSize,
+							const float *probabilities, RowIndex *rows, RowIndex *draftRows);
+
+/**
+ * This function analyses a single meetings' file in batch mode and writes its own output file. The
+ * probabilities are kept in the job's own array, so the people's array is never copied or changed
+ * @param pool - the state shared by the workers
+ * @param job - the job's index in the meetings' paths
+ * @return 1 if succeeded, 0 if failed (the error is already printed)
+ */
+int runBatchJob(BatchPool *pool, int job);
+
+/**
+ * This function is the main function of a worker thread in batch mode, it runs jobs until there
+ * are no jobs left
+ * @param pool - the state shared by the workers (BatchPool *)
+ * @return NULL
+ */
+void *batchWorker(void *pool);
+
+/**
+ * This function analyses every meetings' file against the same people, on a pool of threads
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param meetingsPaths - the paths of the meetings' files
+ * @param jobsAmount - the amount of meetings' files
+ * @param threads - the amount of worker threads, 0 for the amount of online processors
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+int runBatch(Person *peopleList, size_t peopleListSize, char **meetingsPaths, int jobsAmount,
+			 int threads);
+
+/**
+ * This function applies a single meeting to all the sick people at once. Every row keeps a
+ * probability per sick person (a lane), and a mask with a bit for every lane that might be
+ * positive, so meetings of people that nobody reached cost a single check
+ * @param meeting - the meeting to apply
+ * @param lanes - the probabilities, sourcesAmount per row
+ * @param masks - the masks of the rows
+ * @param sourcesAmount - the amount of sick people
+ */
+void applyMultiSourceMeeting(const MeetingRecord *meeting, float *lanes, uint64_t *masks,
+							 int sourcesAmount);
+
+/**
+ * This function analyses the meetings' file for up to MAX_SOURCES sick people (the ids in its first
+ * line) in a single pass, and writes an output file for every sick person, as batch mode does
+ * @param meetingsFile - the meetings' file, closed at the end
+ * @param peopleList - the array of Persons, sorted by id
+ * @param peopleListSize - the size of the array
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+int runMultiSource(FILE *meetingsFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function finds the slot of an id in the live set
+ * @param live - the live set
+ * @param id - the id to find
+ * @return the slot of the id, or the empty slot where it should be inserted
+ */
+size_t liveSlot(const LiveSet *live, unsigned long int id);
+
+/**
+ * This function inserts an id to the live set, or updates its row if it's already there
+ * @param live - the live set
+ * @param id - the id to insert
+ * @param row - the id's row in the people's array
+ * @return 1 if succeeded, 0 if failed
+ */
+int liveInsert(LiveSet *live, unsigned long int id, RowIndex row);
+
+/**
+ * This function removes an id from the live set, if it's there
+ * @param live - the live set
+ * @param id - the id to remove
+ */
+void liveRemove(LiveSet *live, unsigned long int id);
+
+/**
+ * This function reads the data from the meetings' file and accordingly updates the array of
+ * Persons, like readMeetingsFile(), but only keeps the probabilities that can reach the lowest
+ * threshold. A meeting can't raise a probability (the distance is at least MIN_DISTANCE and the
+ * time at most MAX_TIME), so a meeting between two people that can't reach a threshold is skipped
+ * without searching or parsing anything else. The classifications are the same as without pruning,
+ * but the probabilities below the lowest threshold are 0
+ * @param meetingsFile - the meetings' file
+ * @param peopleList - the array to update
+ * @param peopleListSize - the size of the array
+ */
+void readMeetingsFilePruned(FILE *meetingsFile, Person *peopleList, size_t peopleListSize);
+
+/**
+ * This function adds a block to a ring, and waits while the ring is full
+ * @param ring - the ring
+ * @param block - the block
+ * @param stopped - the flag that stops the pipeline
+ * @return 1 if succeeded, 0 if the pipeline was stopped (the block isn't added)
+ */
+int ringPush(SpscRing *ring, MeetingsBlock *block, const int *stopped);
+
+/**
+ * This function takes a block from a ring, and waits while the ring is empty
+ * @param ring - the ring
+ * @param stopped - the flag that stops the pipeline
+ * @return the block, NULL if the ring is empty and the pipeline was stopped
+ */
+MeetingsBlock *ringPop(SpscRing *ring, const int *stopped);
+
+/**
+ * This function frees a block of meetings
+ * @param block - the block
+ */
+void freeBlock(MeetingsBlock *block);
+
+/**
+ * This function allocates a block of meetings
+ * @param status - the kind of the block
+ * @param text - the text of the block (owned by the block)
+ * @param length - the length of the text
+ * @return the block, NULL if failed
+ */
+MeetingsBlock *newBlock(BlockStatus status, char *text, size_t length);
+
+/**
+ * The thread that reads the meetings' file into blocks of whole lines, and hands them to the
+ * parsers in turn. Every parser gets an end block at the end of the file
+ * @param pipeline - the pipeline
+ * @return NULL
+ */
+void *pipelineReader(void *pipeline);
+
+/**
+ * The thread that turns blocks of text into blocks of records (with the rows of the people
+ * resolved) and hands them to the propagation
+ * @param task - the pipeline and the index of the parser
+ * @return NULL
+ */
+void *pipelineParser(void *task);
+
+/**
+ * This function reads the data from the meetings' file and accordingly updates the array of
+ * Persons, like readMeetingsFile(), in a pipeline: a reader thread, parser threads and the
+ * propagation on the calling thread, so the reading, the parsing and the propagation overlap.
+ * The meetings are applied in the file's order, so the probabilities are identical
+ * @param meetingsFile - the meetings' file, closed at the end
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param parsers - the amount of parser threads, 0 for one per processor but the reader and the
+ * propagation
+ * @param blockSize - the amount of bytes in a block
+ */
+void readMeetingsFilePipelined(FILE *meetingsFile, Person *peopleList, size_t peopleListSize,
+							   int parsers, size_t blockSize);
+
+/**
+ * This function tokenizes a line of the meetings' file, without searching its ids
+ * @param line - the line
+ * @param meeting - the meeting to fill
+ * @return 1 if succeeded, 0 if the line isn't a meeting
+ */
+int tokenizeMeeting(char *line, RawMeeting *meeting);
+
+/**
+ * The thread that reads the whole meetings' file into an array of raw meetings
+ * @param tokenizer - the tokenizer, that gets the meetings
+ * @return NULL
+ */
+void *tokenizeMeetings(void *tokenizer);
+
+/**
+ * This function starts tokenizing the meetings' file on another thread, so it overlaps with
+ * reading and sorting the people
+ * @param tokenizer - the tokenizer to start
+ * @param meetingsFile - the meetings' file, closed by the thread
+ * @return 1 if succeeded, 0 if the thread couldn't be created (the file isn't closed)
+ */
+int startTokenizer(MeetingsTokenizer *tokenizer, FILE *meetingsFile);
+
+/**
+ * This function waits for the tokenized meetings, resolves their ids to rows and updates the
+ * array of Persons accordingly, like readMeetingsFile()
+ * @param tokenizer - the started tokenizer, its meetings are freed
+ * @param peopleList - the array to update, sorted by id
+ * @param peopleListSize - the size of the array
+ */
+void applyTokenizedMeetings(MeetingsTokenizer *tokenizer, Person *peopleList,
+							size_t peopleListSize);
+
+/**
+ * This function adds an amount to a counter of the stats, safely from any thread
+ * @param counter - the counter
+ * @param amount - the amount to add
+ */
+void statsAdd(uint64_t *counter, uint64_t amount);
+
+/**
+ * This function accounts an allocation, a reallocation or a release of a subsystem's memory, in
+ * stats mode, safely from any thread
+ * @param subsystem - the subsystem that owns the memory
+ * @param oldBytes - the size of the block before (0 for an allocation)
+ * @param newBytes - the size of the block after (0 for a release)
+ */
+void trackMemory(MemorySubsystem subsystem, uint64_t oldBytes, uint64_t newBytes);
+
+/**
+ * This function raises a high-water mark to a value, safely from any thread
+ * @param peak - the high-water mark
+ * @param value - the value
+ */
+void raisePeak(uint64_t *peak, uint64_t value);
+
+/**
+ * This function returns the amount of bytes read from or written to a file so far
+ * @param file - the file
+ * @return the position in the file, 0 if it's unknown (a pipe)
+ */
+uint64_t fileOffset(FILE *file);
+
+/**
+ * This function returns the time of a monotonic clock
+ * @return the time in seconds
+ */
+double monotonicSeconds(void);
+
+/**
+ * This function starts measuring a phase, in stats mode
+ * @param phase - the phase
+ */
+void phaseBegin(Phase phase);
+
+/**
+ * This function stops measuring a phase, in stats mode
+ * @param phase - the phase
+ * @param rows - the amount of rows the phase handled
+ */
+void phaseEnd(Phase phase, uint64_t rows);
+
+/**
+ * This function prints the report of stats mode: the time, rows/s and MB/s of every phase that ran,
+ * the counters of the run, the memory of every subsystem and the maximal resident set size
+ * @param report - the file to print to
+ */
+void printStats(FILE *report);
+
+/**
+ * This function opens the hardware counters, in perf mode. A counter that can't be opened (not
+ * supported by the machine, or not allowed by perf_event_paranoid) is left out of the report
+ * @return the amount of counters that were opened
+ */
+int perfOpen(void);
+
+/**
+ * This function reads a hardware counter, scaled by the part of the time it was counting (when the
+ * kernel multiplexes more counters than the machine has)
+ * @param fd - the counter
+ * @return the value of the counter, NO_COUNT if it isn't available
+ */
+uint64_t perfRead(int fd);
+
+/**
+ * This function prints the hardware counters of every phase that ran, in perf mode, and closes them
+ * @param report - the file to print to
+ */
+void printPerf(FILE *report);
+
+/**
+ * This function returns the trace buffer of the calling thread, and registers a new one at its
+ * first call on a thread
+ * @return the buffer, NULL if failed
+ */
+TraceBuffer *threadTraceBuffer(void);
+
+/**
+ * This function returns the start of a span, in trace mode
+ * @return the time in seconds, 0 if trace mode is off
+ */
+double traceNow(void);
+
+/**
+ * This function records a span that ends now in the trace buffer of the calling thread, in trace
+ * mode. An event that can't be allocated is dropped and counted
+ * @param name - the name of the span (not copied)
+ * @param category - the category of the span (not copied)
+ * @param start - the start of the span, as returned by traceNow()
+ * @param detail - a number shown with the span (a chunk, a job or a length), NO_DETAIL for none
+ */
+void traceSpan(const char *name, const char *category, double start, long detail);
+
+/**
+ * This function writes the events of all the threads to the trace file, as Chrome trace-event JSON
+ * (that chrome://tracing and Perfetto open), and frees the buffers
+ * @return 1 if succeeded, 0 if failed
+ */
+int writeTrace(void);
+
+/**
+ * This function opens the alerts' file, every person starts as clean
+ * @param path - the path of the alerts' file, or ALERTS_STDOUT
+ * @param peopleListSize - the amount of people
+ * @return 1 if succeeded, 0 if failed
+ */
+int openAlerts(const char *path, size_t peopleListSize);
+
+/**
+ * This function writes an alert if the classification of a person changed, and flushes it at once
+ * @param peopleList - the array of Persons
+ * @param row - the row of the person, whose probability was just updated
+ * @param meeting - the number of the meeting that updated it
+ */
+void alertIfCrossed(Person *peopleList, RowIndex row, uint64_t meeting);
+
+/**
+ * This function closes the alerts' file and frees the classifications
+ * @return 1 if succeeded, 0 if the file couldn't be closed
+ */
+int closeAlerts(void);
+
+/**
+ * This function prints the report of stats mode and of perf mode (if they're enabled) and writes
+ * the trace file (in trace mode) at the end of the run
+ * @param exitCode - the exit code of the run
+ * @return the exit code, EXIT_FAILURE if the trace file couldn't be written
+ */
+int endRun(int exitCode);
+
+#endif //SPREADERDETECTORBACKEND_H
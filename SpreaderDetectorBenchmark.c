@@ -0,0 +1,337 @@
+/**
+ * @file SpreaderDetectorBenchmark.c
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief An end-to-end benchmark of the SpreaderDetectorBackend program on synthetic datasets
+ *
+ * @section LICENSE
+ * This program is a free software.
+ *
+ * @section DESCRIPTION
+ * The benchmark generates datasets of growing sizes (by SpreaderDetectorGenerator), runs the whole
+ * pipeline of the backend on each of them and times every phase: readPeopleFile(), sortById(),
+ * readMeetingsFile(), sortByProbability() and writeOutput(). The results are printed to stdout as
+ * CSV or JSON.
+ */
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "SpreaderDetectorBackend.h"
+#include "SpreaderDetectorGenerator.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def BENCH_USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define BENCH_USAGE_ERROR "USAGE: ./spreader_benchmark [--min <people>] [--max <people>] " \
+						  "[--factor <N>] [--meetings-per-person <N>] [--seed <N>] " \
+						  "[--format csv|json] [--dir <Path>]\n"
+
+/**
+ * @def DEFAULT_MIN_PEOPLE- the default size of the smallest dataset
+ */
+#define DEFAULT_MIN_PEOPLE 1000
+
+/**
+ * @def DEFAULT_MAX_PEOPLE- the default size of the largest dataset (datasets up to 100M people can
+ * be measured with --max, given the memory and the disk)
+ */
+#define DEFAULT_MAX_PEOPLE 1000000
+
+/**
+ * @def DEFAULT_FACTOR- the default growth of the datasets' size
+ */
+#define DEFAULT_FACTOR 10
+
+/**
+ * @def PATH_LENGTH- the maximal length of a path of a benchmark's file
+ */
+#define PATH_LENGTH 4096
+
+/**
+ * @def BENCH_PEOPLE_FILE- the name of the generated people's file in the benchmark's directory
+ */
+#define BENCH_PEOPLE_FILE "bench_people.in"
+
+/**
+ * @def BENCH_MEETINGS_FILE- the name of the generated meetings' file in the benchmark's directory
+ */
+#define BENCH_MEETINGS_FILE "bench_meetings.in"
+
+/**
+ * @def BENCH_OUTPUT_FILE- the name of the output file in the benchmark's directory
+ */
+#define BENCH_OUTPUT_FILE "bench_output.out"
+
+/**
+ * @def NANOS_PER_SECOND- the amount of nanoseconds in a second
+ */
+#define NANOS_PER_SECOND 1000000000.0
+
+/**
+ * @def BYTES_PER_MEGABYTE- the amount of bytes in a megabyte
+ */
+#define BYTES_PER_MEGABYTE 1000000.0
+
+/**
+ * @def BENCH_PHASES- the amount of the measured phases
+ */
+#define BENCH_PHASES 5
+
+/**
+ * @def PhaseResult- a struct that contains the measurement of a single phase
+ */
+typedef struct PhaseResult
+{
+	const char *name;
+	double seconds;
+	uint64_t rows;
+	uint64_t bytes;
+} PhaseResult;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function returns the time of a monotonic clock
+ * @return the time in seconds
+ */
+double now(void);
+
+/**
+ * This function returns the size of a file
+ * @param path - the path of the file
+ * @return the size in bytes, 0 if failed
+ */
+uint64_t fileSize(const char *path);
+
+/**
+ * This function runs the whole pipeline on a dataset and measures every phase
+ * @param dir - the directory of the dataset
+ * @param results - an array of BENCH_PHASES results to fill
+ * @return 1 if succeeded, 0 if failed
+ */
+int runPipeline(const char *dir, PhaseResult *results);
+
+/**
+ * This function prints the results of a single dataset
+ * @param params - the shape of the dataset
+ * @param results - the results of the phases
+ * @param json - 1 to print JSON objects, 0 to print CSV lines
+ * @param first - 1 if it's the first dataset
+ */
+void printResults(const GeneratorParams *params, const PhaseResult *results, int json, int first);
+
+//-------------------------------------------- code  -----------------------------------------------
+
+double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double) time.tv_sec + (double) time.tv_nsec / NANOS_PER_SECOND;
+}
+
+uint64_t fileSize(const char *path)
+{
+	struct stat status;
+	if (stat(path, &status) != 0)
+	{
+		return 0;
+	}
+	return (uint64_t) status.st_size;
+}
+
+int runPipeline(const char *dir, PhaseResult *const results)
+{
+	char peoplePath[PATH_LENGTH];
+	char meetingsPath[PATH_LENGTH];
+	char outputPath[PATH_LENGTH];
+	snprintf(peoplePath, PATH_LENGTH, "%s/%s", dir, BENCH_PEOPLE_FILE);
+	snprintf(meetingsPath, PATH_LENGTH, "%s/%s", dir, BENCH_MEETINGS_FILE);
+	snprintf(outputPath, PATH_LENGTH, "%s/%s", dir, BENCH_OUTPUT_FILE);
+	Person *peopleList = NULL;
+
+	double start = now();
+	FILE *peopleFile = fopen(peoplePath, "r");
+	if (peopleFile == NULL)
+	{
+		fprintf(stderr, IN_FILE_ERROR);
+		return FAILURE;
+	}
+	size_t peopleListSize = readPeopleFile(peopleFile, &peopleList);
+	results[0] = (PhaseResult) {"readPeopleFile", now() - start, peopleListSize,
+								fileSize(peoplePath)};
+
+	start = now();
+	sortById(&peopleList, peopleListSize);
+	results[1] = (PhaseResult) {"sortById", now() - start, peopleListSize, 0};
+
+	start = now();
+	FILE *meetingsFile = fopen(meetingsPath, "r");
+	if (meetingsFile == NULL)
+	{
+		beforeExitFailure(NULL, IN_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFile(meetingsFile, peopleList, peopleListSize);
+	uint64_t meetingsBytes = fileSize(meetingsPath);
+	results[2] = (PhaseResult) {"readMeetingsFile", now() - start, 0, meetingsBytes};
+
+	start = now();
+	sortByProbability(&peopleList, peopleListSize);
+	results[3] = (PhaseResult) {"sortByProbability", now() - start, peopleListSize, 0};
+
+	start = now();
+	FILE *outputFile = fopen(outputPath, "w");
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	writeOutput(outputFile, peopleList, peopleListSize);
+	results[4] = (PhaseResult) {"writeOutput", now() - start, peopleListSize,
+								fileSize(outputPath)};
+	freePeople(peopleList, peopleListSize);
+	return SUCCESS;
+}
+
+void printResults(const GeneratorParams *const params, const PhaseResult *const results, int json,
+				  int first)
+{
+	double total = 0;
+	for (int i = 0; i < BENCH_PHASES; ++i)
+	{
+		const PhaseResult *result = &results[i];
+		uint64_t rows = result->rows != 0 ? result->rows : params->meetingsAmount;
+		double rowsPerSecond = result->seconds > 0 ? rows / result->seconds : 0;
+		double megabytesPerSecond = result->seconds > 0 ?
+									result->bytes / BYTES_PER_MEGABYTE / result->seconds : 0;
+		total += result->seconds;
+		if (json)
+		{
+			printf("%s  {\"people\": %llu, \"meetings\": %llu, \"phase\": \"%s\", "
+				   "\"seconds\": %.6f, \"rows\": %llu, \"bytes\": %llu, "
+				   "\"rows_per_second\": %.0f, \"mb_per_second\": %.2f}",
+				   first && i == 0 ? "" : ",\n", (unsigned long long) params->peopleAmount,
+				   (unsigned long long) params->meetingsAmount, result->name, result->seconds,
+				   (unsigned long long) rows, (unsigned long long) result->bytes, rowsPerSecond,
+				   megabytesPerSecond);
+		}
+		else
+		{
+			printf("%llu,%llu,%s,%.6f,%llu,%llu,%.0f,%.2f\n",
+				   (unsigned long long) params->peopleAmount,
+				   (unsigned long long) params->meetingsAmount, result->name, result->seconds,
+				   (unsigned long long) rows, (unsigned long long) result->bytes, rowsPerSecond,
+				   megabytesPerSecond);
+		}
+	}
+	if (json)
+	{
+		printf(",\n  {\"people\": %llu, \"meetings\": %llu, \"phase\": \"total\", "
+			   "\"seconds\": %.6f}", (unsigned long long) params->peopleAmount,
+			   (unsigned long long) params->meetingsAmount, total);
+	}
+	else
+	{
+		printf("%llu,%llu,total,%.6f,,,,\n", (unsigned long long) params->peopleAmount,
+			   (unsigned long long) params->meetingsAmount, total);
+	}
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t minPeople = DEFAULT_MIN_PEOPLE;
+	uint64_t maxPeople = DEFAULT_MAX_PEOPLE;
+	uint64_t factor = DEFAULT_FACTOR;
+	uint64_t meetingsPerPerson = DEFAULT_MEETINGS_PER_PERSON;
+	GeneratorParams params;
+	defaultGeneratorParams(&params);
+	int json = FAILURE;
+	const char *dir = ".";
+	for (int i = 1; i < argc; i += 2)
+	{
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, BENCH_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+		const char *value = argv[i + 1];
+		if (strcmp(argv[i], "--min") == 0)
+		{
+			minPeople = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--max") == 0)
+		{
+			maxPeople = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--factor") == 0)
+		{
+			factor = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--meetings-per-person") == 0)
+		{
+			meetingsPerPerson = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			params.seed = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--format") == 0 &&
+				 (strcmp(value, "csv") == 0 || strcmp(value, "json") == 0))
+		{
+			json = strcmp(value, "json") == 0;
+		}
+		else if (strcmp(argv[i], "--dir") == 0)
+		{
+			dir = value;
+		}
+		else
+		{
+			fprintf(stderr, BENCH_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+	}
+	if (minPeople == 0 || maxPeople < minPeople || factor < 2)
+	{
+		fprintf(stderr, BENCH_USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	printf(json ? "[\n" : "people,meetings,phase,seconds,rows,bytes,rows_per_second,"
+						  "mb_per_second\n");
+	char peoplePath[PATH_LENGTH];
+	char meetingsPath[PATH_LENGTH];
+	snprintf(peoplePath, PATH_LENGTH, "%s/%s", dir, BENCH_PEOPLE_FILE);
+	snprintf(meetingsPath, PATH_LENGTH, "%s/%s", dir, BENCH_MEETINGS_FILE);
+	for (uint64_t people = minPeople; people <= maxPeople; people *= factor)
+	{
+		params.peopleAmount = people;
+		params.meetingsAmount = people * meetingsPerPerson;
+		FILE *peopleFile = fopen(peoplePath, "w");
+		FILE *meetingsFile = fopen(meetingsPath, "w");
+		int success = peopleFile != NULL && meetingsFile != NULL &&
+					  generateDataset(&params, peopleFile, meetingsFile);
+		success = (peopleFile == NULL || fclose(peopleFile) != EOF) && success;
+		success = (meetingsFile == NULL || fclose(meetingsFile) != EOF) && success;
+		if (!success)
+		{
+			fprintf(stderr, OUT_FILE_ERROR);
+			return EXIT_FAILURE;
+		}
+		PhaseResult results[BENCH_PHASES];
+		if (runPipeline(dir, results) == FAILURE)
+		{
+			return EXIT_FAILURE;
+		}
+		printResults(&params, results, json, people == minPeople);
+	}
+	if (json)
+	{
+		printf("\n]\n");
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1769 @@
+/**
+ * @file SpreaderDetectorDiffTest.c
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief A differential correctness harness of the modes of the SpreaderDetectorBackend program
+ *
+ * @section LICENSE
+ * This program is a free software.
+ *
+ * @section DESCRIPTION
+ * The harness keeps a frozen copy of the original program (its merge sort, its EPSILON comparator
+ * and its output loop, with an exact id comparison and a checked binary search) as the reference,
+ * apart from the backend, so a change of the backend can't change the reference with it. It
+ * generates thousands of random datasets and checks every mode against it: the straightforward
+ * pipeline, binary meetings, batch and multi-source mode must write the same file byte for byte
+ * (and so must the overlapped tokenizer, and the pipeline with tiny blocks so every line may be
+ * split between two of them), server mode must answer with the reference's lines of the people it
+ * reached, external mode (with a budget of a few records, so every sort spills many runs) must
+ * write the same file too, prune mode must classify every person the same, and the compact binary
+ * meetings must keep every probability within COMPACT_MAX_ERROR a meeting of its chain. A run
+ * resumed from a checkpoint, after the rest of the meetings' file was appended (to a line end, or
+ * to the middle of a line), must write the same file as a full run. Delta mode must write the lines
+ * of a full run that aren't lines of the run before it (where everybody was clean, on the first
+ * run), and the result cache must miss, hit with the same output, and miss again after an option or
+ * an input changed. The reference writes an alert whenever a meeting moves a person across a
+ * threshold, and the alerts of the regular mode must be the same, up to their time. The datasets
+ * are small and full of ties: the distances and the durations are drawn from a short list, part of
+ * which lands exactly on the thresholds or EPSILON-close to them, and a quarter of them has ids far
+ * apart, up to ULONG_MAX. Every case has its own seed, so a failure is reproduced by running the
+ * harness with that seed and a single case.
+ */
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "SpreaderDetectorBackend.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def DIFF_USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define DIFF_USAGE_ERROR "USAGE: ./spreader_difftest [--cases <N>] [--seed <N>] " \
+						 "[--max-people <N>] [--dir <Path>]\n"
+
+/**
+ * @def DEFAULT_CASES- the default amount of random datasets
+ */
+#define DEFAULT_CASES 2000
+
+/**
+ * @def DEFAULT_DIFF_SEED- the default seed of the first dataset
+ */
+#define DEFAULT_DIFF_SEED 1
+
+/**
+ * @def DEFAULT_MAX_PEOPLE- the default maximal amount of people in a dataset
+ */
+#define DEFAULT_MAX_PEOPLE 300
+
+/**
+ * @def MAX_MEETINGS_PER_PERSON- the maximal amount of meetings for every person in a dataset
+ */
+#define MAX_MEETINGS_PER_PERSON 6
+
+/**
+ * @def DIFF_MIN_BLOCK- the smallest block of the pipeline check, shorter than most of the lines
+ */
+#define DIFF_MIN_BLOCK 8
+
+/**
+ * @def DIFF_BLOCK_RANGE- the range of the blocks' sizes of the pipeline check
+ */
+#define DIFF_BLOCK_RANGE 120
+
+/**
+ * @def DIFF_PARSERS- the amount of parser threads of the pipeline check
+ */
+#define DIFF_PARSERS 3
+
+/**
+ * @def DIFF_SOURCES- the maximal amount of sick people in the multi-source case
+ */
+#define DIFF_SOURCES 4
+
+/**
+ * @def DIFF_EXTERNAL_BUDGET- the memory budget of the external check, in bytes
+ */
+#define DIFF_EXTERNAL_BUDGET 256
+
+/**
+ * @def FIRST_DIFF_ID- the smallest id of a person
+ */
+#define FIRST_DIFF_ID 100000000
+
+/**
+ * @def ID_RANGE- the range of the ids (9 digits)
+ */
+#define ID_RANGE 900000000
+
+/**
+ * @def WIDE_IDS_PERCENT- the chance (in percents) for a case to draw its ids from the whole range
+ * of unsigned long int, so they are far apart (more than 2^31) and some of them are above 2^63
+ */
+#define WIDE_IDS_PERCENT 25
+
+/**
+ * @def EMPTY_CUT_PERCENT- the chance (in percents) for the first run of the checkpoint check to see
+ * an empty meetings' file
+ */
+#define EMPTY_CUT_PERCENT 10
+
+/**
+ * @def MAX_NAME_LENGTH- the maximal length of a name
+ */
+#define MAX_NAME_LENGTH 8
+
+/**
+ * @def ALPHABET_SIZE- the amount of letters the names are made of
+ */
+#define ALPHABET_SIZE 26
+
+/**
+ * @def REACHED_PERCENT- the chance (in percents) for an infector to be somebody who was already
+ * reached, so the chains are long
+ */
+#define REACHED_PERCENT 70
+
+/**
+ * @def TABLE_PERCENT- the chance (in percents) for a meeting to be drawn from the table of ties,
+ * and not from the continuous ranges
+ */
+#define TABLE_PERCENT 60
+
+/**
+ * @def MAX_DIFF_DISTANCE- the maximal distance of a meeting from the continuous ranges
+ */
+#define MAX_DIFF_DISTANCE 20
+
+/**
+ * @def MAX_LINES- the maximal amount of lines in a compared file
+ */
+#define MAX_LINES 65536
+
+/**
+ * @def DIFF_PEOPLE_FILE- the people's file of a case
+ */
+#define DIFF_PEOPLE_FILE "diff_people.in"
+
+/**
+ * @def DIFF_MEETINGS_FILE- the meetings' file of a case
+ */
+#define DIFF_MEETINGS_FILE "diff_meetings.in"
+
+/**
+ * @def DIFF_SOURCES_FILE- the meetings' file of a case in multi-source mode
+ */
+#define DIFF_SOURCES_FILE "diff_sources.in"
+
+/**
+ * @def DIFF_LANE_FILE- the meetings' file of a single sick person of multi-source mode
+ */
+#define DIFF_LANE_FILE "diff_lane.in"
+
+/**
+ * @def DIFF_BINARY_FILE- the binary meetings' file of a case
+ */
+#define DIFF_BINARY_FILE "diff_meetings.bin"
+
+/**
+ * @def DIFF_REFERENCE_FILE- the output of the reference
+ */
+#define DIFF_REFERENCE_FILE "diff_reference.out"
+
+/**
+ * @def DIFF_MODE_FILE- the output of a checked mode
+ */
+#define DIFF_MODE_FILE "diff_mode.out"
+
+/**
+ * @def DIFF_APPEND_FILE- the meetings' file of the checkpoint check, that is appended to between
+ * its two runs
+ */
+#define DIFF_APPEND_FILE "diff_append.in"
+
+/**
+ * @def DIFF_CHECKPOINT_FILE- the checkpoint of the checkpoint check
+ */
+#define DIFF_CHECKPOINT_FILE "diff_checkpoint.bin"
+
+/**
+ * @def DIFF_CLEAN_FILE- the output of the reference with no meetings, where everybody is clean
+ */
+#define DIFF_CLEAN_FILE "diff_clean.out"
+
+/**
+ * @def DIFF_CLASSES_FILE- the classifications' file of the delta check
+ */
+#define DIFF_CLASSES_FILE "diff_classes.bin"
+
+/**
+ * @def DIFF_DELTA_FILE- the output of delta mode
+ */
+#define DIFF_DELTA_FILE "diff_delta.out"
+
+/**
+ * @def DIFF_CACHE_DIR- the cache's directory of the cache check
+ */
+#define DIFF_CACHE_DIR "diff_cache"
+
+/**
+ * @def DIFF_PROGRAM- the name of the program in the arguments of the cache check
+ */
+#define DIFF_PROGRAM "c_exam"
+
+/**
+ * @def CACHE_OPTIONS- the amount of options checked against the path of a cached output
+ */
+#define CACHE_OPTIONS 7
+
+/**
+ * @def OUTPUT_CHANGING_OPTIONS- the amount of the checked options (the first ones) that must change
+ * the path of a cached output, while the rest must keep it
+ */
+#define OUTPUT_CHANGING_OPTIONS 2
+
+/**
+ * @def DIFF_EXPECTED_ALERTS_FILE- the alerts of the reference, without the time of every alert
+ */
+#define DIFF_EXPECTED_ALERTS_FILE "diff_expected_alerts.out"
+
+/**
+ * @def DIFF_ALERTS_FILE- the alerts of the alerts check
+ */
+#define DIFF_ALERTS_FILE "diff_alerts.out"
+
+/**
+ * @def REFERENCE_ALERT_FORMAT- an alert of the reference: ALERT_FORMAT without the time
+ */
+#define REFERENCE_ALERT_FORMAT "%llu %lu %s %s %s %.6f\n"
+
+/**
+ * The meetings drawn in the cases of ties: whole numbers, the exact thresholds (a duration of 3 or
+ * 9 at a distance of 1 gives 0.1 and 0.3) and values EPSILON-close to them on both sides
+ */
+static const char *const tableDistances[] = {"1", "1", "1", "1", "1", "1", "2", "3", "10",
+											 "1.0000001", "1.00000001"};
+static const char *const tableTimes[] = {"3", "9", "2.9999999", "3.0000001", "8.9999999",
+										 "9.0000001", "30", "15", "30", "9", "30"};
+
+/**
+ * @def REFERENCE_EPSILON- the EPSILON of the original program, frozen with the reference
+ */
+#define REFERENCE_EPSILON 0.000000001
+
+/**
+ * @def ReferencePerson- a person of the reference, apart from the backend's Person
+ */
+typedef struct ReferencePerson
+{
+	char *name;
+	unsigned long int id;
+	float probability;
+	int classification;
+} ReferencePerson;
+
+/**
+ * @def ReferenceCompare- a comparator of the reference's merge sort
+ */
+typedef int (*ReferenceCompare)(const ReferencePerson *, const ReferencePerson *);
+
+/**
+ * @def ReferenceClassification- a classification of the reference, an index in referenceClasses
+ */
+typedef enum ReferenceClassification
+{
+	REFERENCE_CLEAN,
+	REFERENCE_QUARANTINE,
+	REFERENCE_HOSPITALIZATION
+} ReferenceClassification;
+
+/**
+ * @def ReferenceClass- a classification of the reference: its name in an alert, and its line in
+ * the output
+ */
+typedef struct ReferenceClass
+{
+	const char *name;
+	const char *format;
+} ReferenceClass;
+
+static const ReferenceClass referenceClasses[] = {{"CLEAN", CLEAN_MSG},
+												  {"QUARANTINE", REGULAR_QUARANTINE_MSG},
+												  {"HOSPITALIZATION",
+												   MEDICAL_SUPERVISION_THRESHOLD_MSG}};
+
+/**
+ * @def DiffCase- a struct that contains a random dataset
+ */
+typedef struct DiffCase
+{
+	unsigned long int *ids;
+	int peopleAmount;
+	char *meetings;
+	size_t meetingsLength;
+	unsigned long int sources[DIFF_SOURCES];
+	int sourcesAmount;
+} DiffCase;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function returns the next number of a random sequence (SplitMix64)
+ * @param state - the state of the sequence
+ * @return a random number
+ */
+uint64_t nextRandom(uint64_t *state);
+
+/**
+ * This function returns a random number in a range
+ * @param state - the state of the sequence
+ * @param bound - the end of the range (not included)
+ * @return a random number from 0 to bound - 1
+ */
+int randomBelow(uint64_t *state, int bound);
+
+/**
+ * This function generates a random dataset and writes its people's file
+ * @param seed - the seed of the case
+ * @param maxPeople - the maximal amount of people
+ * @param diffCase - the struct to fill
+ * @return 1 if succeeded, 0 if failed
+ */
+int generateCase(uint64_t seed, int maxPeople, DiffCase *diffCase);
+
+/**
+ * This function writes a meetings' file of a case
+ * @param path - the path of the file
+ * @param diffCase - the case
+ * @param sources - the sick ids
+ * @param sourcesAmount - the amount of sick ids (0 for an empty file)
+ * @return 1 if succeeded, 0 if failed
+ */
+int writeMeetings(const char *path, const DiffCase *diffCase, const unsigned long int *sources,
+				  int sourcesAmount);
+
+/**
+ * This function reads a people's file and sorts it by id, like the program does
+ * @param path - the path of the file
+ * @param peopleListSize - the size of the array, set by the function
+ * @return the array of people
+ */
+Person *loadPeople(const char *path, size_t *peopleListSize);
+
+/**
+ * This function compares the ids of two people of the reference
+ * @param a - the first person
+ * @param b - the second person
+ * @return a negative number, 0 or a positive number, like strcmp()
+ */
+int referenceIdCompare(const ReferencePerson *a, const ReferencePerson *b);
+
+/**
+ * This function compares the probabilities of two people of the reference, the original way (equal
+ * within REFERENCE_EPSILON)
+ * @param a - the first person
+ * @param b - the second person
+ * @return a negative number, 0 or a positive number, like strcmp()
+ */
+int referenceProbCompare(const ReferencePerson *a, const ReferencePerson *b);
+
+/**
+ * This function sorts people of the reference with the original merge sort
+ * @param peopleList - the array to sort
+ * @param draftList - a draft array of the same length
+ * @param length - the length of the range to sort
+ * @param start - the start of the range to sort
+ * @param compare - the comparator
+ */
+void referenceMergeSort(ReferencePerson *peopleList, ReferencePerson *draftList, size_t length,
+						size_t start, ReferenceCompare compare);
+
+/**
+ * This function finds a person of the reference by id
+ * @param peopleList - the array, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param id - the id to find
+ * @return the index of the person, peopleListSize if there is no such person
+ */
+size_t referenceFind(const ReferencePerson *peopleList, size_t peopleListSize,
+					 unsigned long int id);
+
+/**
+ * This function classifies a probability of the reference, the original way
+ * @param probability - the probability
+ * @return the index of the classification in referenceClasses
+ */
+int referenceClassify(float probability);
+
+/**
+ * This function writes an alert of the reference if the classification of a person changed
+ * @param alertsFile - the reference's alerts, NULL for none
+ * @param person - the person, whose probability was just updated
+ * @param meeting - the number of the meeting that updated it (0 for the sick person)
+ */
+void referenceAlert(FILE *alertsFile, ReferencePerson *person, unsigned long long meeting);
+
+/**
+ * This function reads a people's file into people of the reference
+ * @param path - the path of the file
+ * @param peopleListSize - the size of the array, set by the function
+ * @return the array of people, NULL if failed
+ */
+ReferencePerson *referenceReadPeople(const char *path, size_t *peopleListSize);
+
+/**
+ * This function applies a meetings' file to people of the reference
+ * @param path - the path of the file
+ * @param peopleList - the array, sorted by id
+ * @param peopleListSize - the size of the array
+ * @param alertsFile - the reference's alerts, NULL for none
+ * @return 1 if succeeded, 0 if failed (or if the file has an unknown id)
+ */
+int referenceReadMeetings(const char *path, ReferencePerson *peopleList, size_t peopleListSize,
+						  FILE *alertsFile);
+
+/**
+ * This function frees people of the reference
+ * @param peopleList - the array
+ * @param peopleListSize - the size of the array
+ */
+void referenceFree(ReferencePerson *peopleList, size_t peopleListSize);
+
+/**
+ * This function runs the reference pipeline
+ * @param meetingsPath - the meetings' file
+ * @param outputPath - the output file
+ * @param alertsPath - the file of the reference's alerts, NULL for none
+ * @return 1 if succeeded, 0 if failed
+ */
+int runReference(const char *meetingsPath, const char *outputPath, const char *alertsPath);
+
+/**
+ * This function reads the lines of a file
+ * @param path - the path of the file
+ * @param lines - an array of MAX_LINES lines to fill, freed by freeLines()
+ * @return the amount of lines, -1 if failed
+ */
+int readFileLines(const char *path, char **lines);
+
+/**
+ * This function frees the lines of a file
+ * @param lines - the lines
+ * @param amount - the amount of lines
+ */
+void freeLines(char **lines, int amount);
+
+/**
+ * This function compares two strings, for qsort()
+ * @param a - a pointer to the first string
+ * @param b - a pointer to the second string
+ * @return the result of strcmp()
+ */
+int compareLines(const void *a, const void *b);
+
+/**
+ * This function compares two files byte for byte
+ * @param path1 - the first file
+ * @param path2 - the second file
+ * @return 1 if they're identical, 0 if not
+ */
+int sameFiles(const char *path1, const char *path2);
+
+/**
+ * This function checks the straightforward pipeline (readMeetingsFile(), sortByProbability() and
+ * writeOutput()) against the reference
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkText(void);
+
+/**
+ * This function checks the binary meetings against the reference
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkBinary(void);
+
+/**
+ * This function checks the compact binary meetings against the probabilities of the reference:
+ * every meeting may add COMPACT_MAX_ERROR to the error of its infector's probability
+ * @return 1 if every probability is within its bound, 0 if not
+ */
+int checkCompact(void);
+
+/**
+ * This function checks the pipeline against the reference, with blocks of a few bytes
+ * @param caseSeed - the seed of the case, that picks the size of the blocks
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkPipeline(uint64_t caseSeed);
+
+/**
+ * This function checks the meetings tokenized during the load of the people against the reference
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkOverlap(void);
+
+/**
+ * This function checks batch mode against the reference
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkBatch(void);
+
+/**
+ * This function checks multi-source mode against a reference run of every sick person
+ * @param diffCase - the case
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkMultiSource(const DiffCase *diffCase);
+
+/**
+ * This function returns whether a line of the output is of a clean person
+ * @param line - the line
+ * @return 1 if the person is clean, 0 if not
+ */
+int isClean(const char *line);
+
+/**
+ * This function checks the output of a mode against the reference: it must start with the same
+ * lines of the people that aren't clean, in the same order, and the rest of its lines must be lines
+ * of the reference. The clean people may be in another order: the probabilities are equal up to
+ * EPSILON, which isn't transitive for probabilities that small, so another sort (or a sort of only
+ * a part of the people) may order them differently
+ * @param complete - whether the output must have all the lines of the reference
+ * @return 1 if the output is right, 0 if not
+ */
+int sameUpToCleanOrder(int complete);
+
+/**
+ * This function checks server mode against the reference, up to the order of the clean people
+ * @return 1 if the response is right, 0 if not
+ */
+int checkServer(void);
+
+/**
+ * This function checks external mode against the reference, byte for byte
+ * @return 1 if the output is right, 0 if not
+ */
+int checkExternal(void);
+
+/**
+ * This function checks prune mode against the reference: every person must have the same line,
+ * whatever its place in the file
+ * @return 1 if the classifications are identical, 0 if not
+ */
+int checkPrune(void);
+
+/**
+ * This function writes the first bytes of a buffer to a file
+ * @param path - the file
+ * @param bytes - the buffer
+ * @param length - the amount of bytes to write
+ * @return 1 if succeeded, 0 if not
+ */
+int writeBytes(const char *path, const char *bytes, size_t length);
+
+/**
+ * This function checks the alerts of the regular mode against the reference's: an alert must be
+ * written exactly when a meeting moves a person across a threshold, in the reference's order, with
+ * the same meeting, person, classifications and probability
+ * @return 1 if the alerts are the same, 0 if not
+ */
+int checkAlerts(void);
+
+/**
+ * This function runs the regular mode with the checkpoint of the checkpoint check, on the file that
+ * is appended to
+ * @return 1 if succeeded, 0 if not
+ */
+int runIncremental(void);
+
+/**
+ * This function checks whether the checkpoint of the checkpoint check matches the file that is
+ * appended to, so the next run resumes from it
+ * @return 1 if it matches, 0 if not
+ */
+int resumes(void);
+
+/**
+ * This function checks a run resumed from a checkpoint against the reference: the first run sees
+ * only a part of the meetings' file (nothing at all, or a part that ends in the middle of a line or
+ * at a line end), and the second run, after the rest was appended, must resume from the checkpoint
+ * and write the same file as a full run
+ * @param caseSeed - the seed of the case, that picks where the file is cut
+ * @return 1 if the outputs are identical, 0 if not
+ */
+int checkCheckpoint(uint64_t caseSeed);
+
+/**
+ * This function runs delta mode on a meetings' file, with the classifications' file of the delta
+ * check
+ * @param meetingsPath - the meetings' file
+ * @return 1 if succeeded, 0 if not
+ */
+int runDelta(const char *meetingsPath);
+
+/**
+ * This function checks the output of delta mode: its lines must be the lines of the new full run
+ * that aren't lines of the old one (a line has the classification, the name and the id), in any
+ * order
+ * @param newPath - the output of the reference on the meetings of the delta run
+ * @param oldPath - the output of the reference on the meetings of the run before it
+ * @return 1 if the output is the difference, 0 if not
+ */
+int isDifference(const char *newPath, const char *oldPath);
+
+/**
+ * This function checks delta mode against the reference in two runs: the first one, with no
+ * classifications' file, must write only the people who aren't clean, and the second one (on the
+ * meetings of another sick person) only the people whose line changed since the first one
+ * @param diffCase - the case
+ * @return 1 if both outputs are right, 0 if not
+ */
+int checkDelta(const DiffCase *diffCase);
+
+/**
+ * This function finds the path of the cached output of the cache check's files, with an option
+ * @param option - the option, NULL for none
+ * @param value - the value of the option, NULL if it doesn't have one
+ * @return the path (freed by the caller), NULL if failed
+ */
+char *cachePath(const char *option, const char *value);
+
+/**
+ * This function checks the result cache: a miss, the output stored, a hit that writes the same
+ * output, another path for every option that changes the output (and the same path for the modes
+ * that write the same output, and for --stats), and a miss after the meetings' file changed in
+ * place
+ * @param diffCase - the case
+ * @return 1 if the cache is right, 0 if not
+ */
+int checkCache(const DiffCase *diffCase);
+
+/**
+ * This function removes the files of the cases and the harness' directory
+ * @param dir - the directory
+ */
+void removeFiles(const char *dir);
+
+//-------------------------------------------- code  -----------------------------------------------
+
+uint64_t nextRandom(uint64_t *const state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+int randomBelow(uint64_t *const state, int bound)
+{
+	return (int) (nextRandom(state) % (uint64_t) bound);
+}
+
+int generateCase(uint64_t seed, int maxPeople, DiffCase *const diffCase)
+{
+	uint64_t state = seed;
+	int people = 1 + randomBelow(&state, maxPeople);
+	diffCase->peopleAmount = people;
+	diffCase->ids = (unsigned long int *) malloc(sizeof(unsigned long int) * people);
+	int *reached = (int *) malloc(sizeof(int) * people);
+	FILE *peopleFile = fopen(DIFF_PEOPLE_FILE, "w");
+	FILE *meetings = open_memstream(&diffCase->meetings, &diffCase->meetingsLength);
+	if (diffCase->ids == NULL || reached == NULL || peopleFile == NULL || meetings == NULL)
+	{
+		free(reached);
+		return FAILURE;
+	}
+	int wide = randomBelow(&state, 100) < WIDE_IDS_PERCENT;
+	for (int i = 0; i < people; ++i)
+	{
+		// distinct ids: every person gets its own part of the range
+		if (wide)
+		{
+			unsigned long int part = ULONG_MAX / (unsigned long int) people;
+			diffCase->ids[i] = (unsigned long int) i * part + nextRandom(&state) % part;
+		}
+		else
+		{
+			diffCase->ids[i] = FIRST_DIFF_ID + (unsigned long int) i * (ID_RANGE / people) +
+							   randomBelow(&state, ID_RANGE / people);
+		}
+		reached[i] = i;
+	}
+	if (wide && people > 1)
+	{
+		diffCase->ids[people - 1] = ULONG_MAX; // the largest id there is
+	}
+	for (int i = people - 1; i > 0; --i) // the people's file is shuffled, so the sort has work
+	{
+		int j = randomBelow(&state, i + 1);
+		int temp = reached[i];
+		reached[i] = reached[j];
+		reached[j] = temp;
+	}
+	for (int i = 0; i < people; ++i)
+	{
+		char name[MAX_NAME_LENGTH + 1];
+		int length = 1 + randomBelow(&state, MAX_NAME_LENGTH);
+		for (int c = 0; c < length; ++c)
+		{
+			name[c] = (char) ('a' + randomBelow(&state, ALPHABET_SIZE));
+		}
+		name[length] = '\0';
+		fprintf(peopleFile, "%s %lu %d\n", name, diffCase->ids[reached[i]],
+				1 + randomBelow(&state, 99));
+	}
+	diffCase->sourcesAmount = people < DIFF_SOURCES ? people : DIFF_SOURCES;
+	int sick = randomBelow(&state, people);
+	for (int i = 0; i < diffCase->sourcesAmount; ++i)
+	{
+		diffCase->sources[i] = diffCase->ids[(sick + i) % people];
+	}
+	reached[0] = sick;
+	int reachedAmount = 1;
+	int meetingsAmount = people > 1 ? randomBelow(&state, people * MAX_MEETINGS_PER_PERSON + 1) : 0;
+	int continuous = randomBelow(&state, 100) >= TABLE_PERCENT;
+	for (int i = 0; i < meetingsAmount; ++i)
+	{
+		int infector = randomBelow(&state, 100) < REACHED_PERCENT ?
+					   reached[randomBelow(&state, reachedAmount)] : randomBelow(&state, people);
+		int infected = (infector + 1 + randomBelow(&state, people - 1)) % people;
+		fprintf(meetings, "%lu %lu ", diffCase->ids[infector], diffCase->ids[infected]);
+		if (continuous)
+		{
+			fprintf(meetings, "%.4f %.4f\n",
+					MIN_DISTANCE + (nextRandom(&state) >> 11) * 0x1.0p-53 * MAX_DIFF_DISTANCE,
+					(nextRandom(&state) >> 11) * 0x1.0p-53 * MAX_TIME);
+		}
+		else
+		{
+			int entry = randomBelow(&state, sizeof(tableTimes) / sizeof(tableTimes[0]));
+			fprintf(meetings, "%s %s\n", tableDistances[entry], tableTimes[entry]);
+		}
+		if (reachedAmount < people)
+		{
+			reached[reachedAmount] = infected;
+			++reachedAmount;
+		}
+	}
+	free(reached);
+	int success = fclose(meetings) != EOF;
+	return fclose(peopleFile) != EOF && success;
+}
+
+int writeMeetings(const char *path, const DiffCase *const diffCase,
+				  const unsigned long int *const sources, int sourcesAmount)
+{
+	FILE *meetingsFile = fopen(path, "w");
+	if (meetingsFile == NULL)
+	{
+		return FAILURE;
+	}
+	if (sourcesAmount > 0)
+	{
+		for (int i = 0; i < sourcesAmount; ++i)
+		{
+			fprintf(meetingsFile, i == 0 ? "%lu" : " %lu", sources[i]);
+		}
+		fprintf(meetingsFile, "\n");
+		fwrite(diffCase->meetings, 1, diffCase->meetingsLength, meetingsFile);
+	}
+	return fclose(meetingsFile) != EOF;
+}
+
+Person *loadPeople(const char *path, size_t *const peopleListSize)
+{
+	FILE *peopleFile = fopen(path, "r");
+	if (peopleFile == NULL)
+	{
+		fprintf(stderr, IN_FILE_ERROR);
+		exit(EXIT_FAILURE);
+	}
+	Person *peopleList = NULL;
+	*peopleListSize = readPeopleFile(peopleFile, &peopleList);
+	sortById(&peopleList, *peopleListSize);
+	return peopleList;
+}
+
+int referenceIdCompare(const ReferencePerson *const a, const ReferencePerson *const b)
+{
+	return (a->id > b->id) - (a->id < b->id);
+}
+
+int referenceProbCompare(const ReferencePerson *const a, const ReferencePerson *const b)
+{
+	if (fabsf(a->probability - b->probability) < REFERENCE_EPSILON)
+	{
+		return 0;
+	}
+	return a->probability > b->probability ? 1 : -1;
+}
+
+void referenceMergeSort(ReferencePerson *const peopleList, ReferencePerson *const draftList,
+						size_t length, size_t start, ReferenceCompare compare)
+{
+	if (length < 2)
+	{
+		return;
+	}
+	size_t aLen = length / 2;
+	size_t bLen = length - aLen;
+	referenceMergeSort(peopleList, draftList, aLen, start, compare);
+	referenceMergeSort(peopleList, &draftList[aLen], bLen, aLen + start, compare);
+	memcpy(draftList, &peopleList[start], sizeof(ReferencePerson) * length);
+	const ReferencePerson *a = draftList;
+	const ReferencePerson *b = &draftList[aLen];
+	size_t aI = 0;
+	size_t bI = 0;
+	while (aI < aLen || bI < bLen)
+	{
+		if (bI == bLen || (aI < aLen && compare(&a[aI], &b[bI]) < 0))
+		{
+			peopleList[start + aI + bI] = a[aI];
+			aI++;
+		}
+		else
+		{
+			peopleList[start + aI + bI] = b[bI];
+			bI++;
+		}
+	}
+}
+
+size_t referenceFind(const ReferencePerson *const peopleList, size_t peopleListSize,
+					 unsigned long int id)
+{
+	size_t start = 0;
+	size_t end = peopleListSize;
+	while (start < end)
+	{
+		size_t mid = start + ((end - start) / 2);
+		if (peopleList[mid].id == id)
+		{
+			return mid;
+		}
+		if (peopleList[mid].id < id)
+		{
+			start = mid + 1;
+		}
+		else
+		{
+			end = mid;
+		}
+	}
+	return peopleListSize;
+}
+
+int referenceClassify(float probability)
+{
+	if (probability >= MEDICAL_SUPERVISION_THRESHOLD ||
+		fabsf(probability - MEDICAL_SUPERVISION_THRESHOLD) < REFERENCE_EPSILON)
+	{
+		return REFERENCE_HOSPITALIZATION;
+	}
+	if (probability >= REGULAR_QUARANTINE_THRESHOLD ||
+		fabsf(probability - REGULAR_QUARANTINE_THRESHOLD) < REFERENCE_EPSILON)
+	{
+		return REFERENCE_QUARANTINE;
+	}
+	return REFERENCE_CLEAN;
+}
+
+void referenceAlert(FILE *const alertsFile, ReferencePerson *const person,
+					unsigned long long meeting)
+{
+	int classification = referenceClassify(person->probability);
+	if (alertsFile != NULL && classification != person->classification)
+	{
+		fprintf(alertsFile, REFERENCE_ALERT_FORMAT, meeting, person->id, person->name,
+				referenceClasses[person->classification].name,
+				referenceClasses[classification].name, person->probability);
+		person->classification = classification;
+	}
+}
+
+ReferencePerson *referenceReadPeople(const char *path, size_t *const peopleListSize)
+{
+	FILE *peopleFile = fopen(path, "r");
+	if (peopleFile == NULL)
+	{
+		return NULL;
+	}
+	size_t capacity = 1;
+	ReferencePerson *peopleList = (ReferencePerson *) malloc(sizeof(ReferencePerson) * capacity);
+	*peopleListSize = 0;
+	char line[MAX_LINE_LENGTH];
+	while (peopleList != NULL && fgets(line, MAX_LINE_LENGTH, peopleFile) != NULL)
+	{
+		char *name = strtok(line, " ");
+		char *id = strtok(NULL, " ");
+		if (name == NULL || id == NULL)
+		{
+			continue;
+		}
+		if (*peopleListSize == capacity)
+		{
+			capacity *= 2;
+			ReferencePerson *grown =
+					(ReferencePerson *) realloc(peopleList, sizeof(ReferencePerson) * capacity);
+			if (grown == NULL)
+			{
+				referenceFree(peopleList, *peopleListSize);
+				peopleList = NULL;
+				break;
+			}
+			peopleList = grown;
+		}
+		ReferencePerson *person = &peopleList[*peopleListSize];
+		person->name = (char *) malloc(strlen(name) + 1);
+		if (person->name == NULL)
+		{
+			referenceFree(peopleList, *peopleListSize);
+			peopleList = NULL;
+			break;
+		}
+		strcpy(person->name, name);
+		person->id = strtoul(id, NULL, 10);
+		person->probability = 0;
+		person->classification = REFERENCE_CLEAN;
+		++*peopleListSize;
+	}
+	fclose(peopleFile);
+	return peopleList;
+}
+
+int referenceReadMeetings(const char *path, ReferencePerson *const peopleList,
+						  size_t peopleListSize, FILE *const alertsFile)
+{
+	FILE *meetingsFile = fopen(path, "r");
+	if (meetingsFile == NULL)
+	{
+		return FAILURE;
+	}
+	char line[MAX_LINE_LENGTH];
+	int success = SUCCESS;
+	if (fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		size_t sick = referenceFind(peopleList, peopleListSize, strtoul(line, NULL, 10));
+		success = sick < peopleListSize;
+		if (success)
+		{
+			peopleList[sick].probability = 1;
+			referenceAlert(alertsFile, &peopleList[sick], 0);
+		}
+	}
+	unsigned long long meeting = 0;
+	while (success && fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+	{
+		++meeting;
+		unsigned long int infectorId = strtoul(strtok(line, " "), NULL, 10);
+		unsigned long int infectedId = strtoul(strtok(NULL, " "), NULL, 10);
+		float distance = strtof(strtok(NULL, " "), NULL);
+		float time = strtof(strtok(NULL, " "), NULL);
+		size_t infector = referenceFind(peopleList, peopleListSize, infectorId);
+		size_t infected = referenceFind(peopleList, peopleListSize, infectedId);
+		success = infector < peopleListSize && infected < peopleListSize;
+		if (success)
+		{
+			float numerator = time * MIN_DISTANCE;
+			float denominator = distance * MAX_TIME;
+			peopleList[infected].probability =
+					peopleList[infector].probability * (numerator / denominator);
+			referenceAlert(alertsFile, &peopleList[infected], meeting);
+		}
+	}
+	fclose(meetingsFile);
+	return success;
+}
+
+void referenceFree(ReferencePerson *const peopleList, size_t peopleListSize)
+{
+	for (size_t i = 0; i < peopleListSize; ++i)
+	{
+		free(peopleList[i].name);
+	}
+	free(peopleList);
+}
+
+int runReference(const char *meetingsPath, const char *outputPath, const char *alertsPath)
+{
+	size_t peopleListSize = 0;
+	ReferencePerson *peopleList = referenceReadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	ReferencePerson *draftList = (ReferencePerson *) malloc(sizeof(ReferencePerson) *
+															(peopleListSize + 1));
+	FILE *alertsFile = alertsPath != NULL ? fopen(alertsPath, "w") : NULL;
+	FILE *outputFile = NULL;
+	int success = peopleList != NULL && draftList != NULL &&
+				  (alertsPath == NULL || alertsFile != NULL);
+	if (success)
+	{
+		referenceMergeSort(peopleList, draftList, peopleListSize, 0, referenceIdCompare);
+		success = referenceReadMeetings(meetingsPath, peopleList, peopleListSize, alertsFile) &&
+				  (outputFile = fopen(outputPath, "w")) != NULL;
+	}
+	if (alertsFile != NULL)
+	{
+		success = fclose(alertsFile) != EOF && success;
+	}
+	if (success)
+	{
+		referenceMergeSort(peopleList, draftList, peopleListSize, 0, referenceProbCompare);
+		for (size_t i = peopleListSize; i-- > 0;)
+		{
+			const ReferencePerson *person = &peopleList[i];
+			fprintf(outputFile, referenceClasses[referenceClassify(person->probability)].format,
+					person->name, person->id);
+		}
+		success = fclose(outputFile) != EOF;
+	}
+	free(draftList);
+	if (peopleList != NULL)
+	{
+		referenceFree(peopleList, peopleListSize);
+	}
+	return success;
+}
+
+int readFileLines(const char *path, char **const lines)
+{
+	FILE *file = fopen(path, "r");
+	if (file == NULL)
+	{
+		return -1;
+	}
+	char line[MAX_LINE_LENGTH];
+	int amount = 0;
+	while (amount < MAX_LINES && fgets(line, MAX_LINE_LENGTH, file) != NULL)
+	{
+		lines[amount] = strdup(line);
+		++amount;
+	}
+	fclose(file);
+	return amount;
+}
+
+void freeLines(char **const lines, int amount)
+{
+	for (int i = 0; i < amount; ++i)
+	{
+		free(lines[i]);
+	}
+}
+
+int compareLines(const void *a, const void *b)
+{
+	return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+int sameFiles(const char *path1, const char *path2)
+{
+	FILE *file1 = fopen(path1, "r");
+	FILE *file2 = fopen(path2, "r");
+	int same = file1 != NULL && file2 != NULL;
+	while (same)
+	{
+		int c1 = fgetc(file1);
+		int c2 = fgetc(file2);
+		same = c1 == c2;
+		if (c1 == EOF)
+		{
+			break;
+		}
+	}
+	if (file1 != NULL)
+	{
+		fclose(file1);
+	}
+	if (file2 != NULL)
+	{
+		fclose(file2);
+	}
+	return same;
+}
+
+int checkText(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *outputFile = meetingsFile != NULL ? fopen(DIFF_MODE_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFile(meetingsFile, peopleList, peopleListSize);
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+}
+
+int checkBinary(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *binaryFile = meetingsFile != NULL ? fopen(DIFF_BINARY_FILE, "wb") : NULL;
+	if (binaryFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	const char *error = convertMeetingsFile(meetingsFile, binaryFile, peopleList, peopleListSize,
+											FAILURE);
+	if (fclose(binaryFile) == EOF || error != NULL)
+	{
+		freePeople(peopleList, peopleListSize);
+		return FAILURE;
+	}
+	binaryFile = fopen(DIFF_BINARY_FILE, "rb");
+	FILE *outputFile = binaryFile != NULL ? fopen(DIFF_MODE_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(binaryFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readBinaryMeetingsFile(binaryFile, peopleList, peopleListSize);
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+}
+
+int checkCompact(void)
+{
+	size_t peopleListSize;
+	Person *referenceList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	float *bounds = (float *) calloc(sizeof(float), peopleListSize + 1);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *binaryFile = meetingsFile != NULL ? fopen(DIFF_BINARY_FILE, "wb") : NULL;
+	if (bounds == NULL || binaryFile == NULL)
+	{
+		free(bounds);
+		freePeople(referenceList, peopleListSize);
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	const char *error = convertMeetingsFile(meetingsFile, binaryFile, peopleList, peopleListSize,
+											SUCCESS);
+	int converted = fclose(binaryFile) != EOF && error == NULL;
+	binaryFile = converted ? fopen(DIFF_BINARY_FILE, "rb") : NULL;
+	meetingsFile = binaryFile != NULL ? fopen(DIFF_MEETINGS_FILE, "r") : NULL;
+	int same = binaryFile != NULL && meetingsFile != NULL;
+	if (same)
+	{
+		readBinaryMeetingsFile(binaryFile, peopleList, peopleListSize);
+		char line[MAX_LINE_LENGTH];
+		if (fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL) // the sick person is exact
+		{
+			while (fgets(line, MAX_LINE_LENGTH, meetingsFile) != NULL)
+			{
+				MeetingRecord meeting;
+				parseMeeting(referenceList, peopleListSize, line, &meeting);
+				bounds[meeting.infectedRow] = bounds[meeting.infectorRow] + COMPACT_MAX_ERROR;
+			}
+		}
+		rewind(meetingsFile);
+		readMeetingsFile(meetingsFile, referenceList, peopleListSize);
+		for (size_t i = 0; same && i < peopleListSize; ++i)
+		{
+			float error = peopleList[i].probability - referenceList[i].probability;
+			same = error <= bounds[i] && -error <= bounds[i];
+		}
+	}
+	else if (binaryFile != NULL)
+	{
+		fclose(binaryFile);
+	}
+	free(bounds);
+	freePeople(referenceList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return same;
+}
+
+int checkPipeline(uint64_t caseSeed)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *outputFile = meetingsFile != NULL ? fopen(DIFF_MODE_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFilePipelined(meetingsFile, peopleList, peopleListSize, DIFF_PARSERS,
+							  DIFF_MIN_BLOCK + caseSeed % DIFF_BLOCK_RANGE);
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+}
+
+int checkOverlap(void)
+{
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	MeetingsTokenizer tokenizer;
+	if (meetingsFile == NULL || startTokenizer(&tokenizer, meetingsFile) == FAILURE)
+	{
+		beforeExitFailure(meetingsFile, STANDARD_LIB_ERR_MSG, NULL, 0);
+		return FAILURE;
+	}
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *outputFile = fopen(DIFF_MODE_FILE, "w");
+	applyTokenizedMeetings(&tokenizer, peopleList, peopleListSize);
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(NULL, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+}
+
+int checkBatch(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	char *paths[] = {DIFF_MEETINGS_FILE, DIFF_MEETINGS_FILE};
+	int exitCode = runBatch(peopleList, peopleListSize, paths, 2, 2);
+	freePeople(peopleList, peopleListSize);
+	char outputPath[BATCH_OUTPUT_LENGTH];
+	int same = exitCode == EXIT_SUCCESS;
+	for (int job = 1; job <= 2 && same; ++job)
+	{
+		snprintf(outputPath, BATCH_OUTPUT_LENGTH, BATCH_OUTPUT_FILE, job);
+		same = sameFiles(DIFF_REFERENCE_FILE, outputPath);
+	}
+	return same;
+}
+
+int checkMultiSource(const DiffCase *const diffCase)
+{
+	if (writeMeetings(DIFF_SOURCES_FILE, diffCase, diffCase->sources,
+					  diffCase->sourcesAmount) == FAILURE)
+	{
+		return FAILURE;
+	}
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_SOURCES_FILE, "r");
+	if (meetingsFile == NULL)
+	{
+		beforeExitFailure(NULL, IN_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	int exitCode = runMultiSource(meetingsFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	int same = exitCode == EXIT_SUCCESS;
+	for (int lane = 0; lane < diffCase->sourcesAmount && same; ++lane)
+	{
+		char outputPath[BATCH_OUTPUT_LENGTH];
+		snprintf(outputPath, BATCH_OUTPUT_LENGTH, BATCH_OUTPUT_FILE, lane + 1);
+		same = writeMeetings(DIFF_LANE_FILE, diffCase, &diffCase->sources[lane], 1) &&
+			   runReference(DIFF_LANE_FILE, DIFF_MODE_FILE, NULL) &&
+			   sameFiles(DIFF_MODE_FILE, outputPath);
+	}
+	return same;
+}
+
+int isClean(const char *line)
+{
+	return strncmp(line, CLEAN_MSG, strcspn(CLEAN_MSG, "%")) == 0;
+}
+
+int sameUpToCleanOrder(int complete)
+{
+	static char *referenceLines[MAX_LINES];
+	static char *outputLines[MAX_LINES];
+	int referenceAmount = readFileLines(DIFF_REFERENCE_FILE, referenceLines);
+	int outputAmount = readFileLines(DIFF_MODE_FILE, outputLines);
+	int same = referenceAmount >= 0 && outputAmount >= 0 &&
+			   (!complete || referenceAmount == outputAmount);
+	int prefix = 0;
+	while (same && prefix < referenceAmount && !isClean(referenceLines[prefix]))
+	{
+		same = prefix < outputAmount &&
+			   strcmp(referenceLines[prefix], outputLines[prefix]) == 0;
+		++prefix;
+	}
+	if (same)
+	{
+		qsort(referenceLines, referenceAmount, sizeof(char *), compareLines);
+		qsort(outputLines, outputAmount, sizeof(char *), compareLines);
+		int matched = 0;
+		for (int i = 0; i < referenceAmount && matched < outputAmount; ++i)
+		{
+			matched += strcmp(referenceLines[i], outputLines[matched]) == 0;
+		}
+		same = matched == outputAmount;
+	}
+	freeLines(referenceLines, referenceAmount);
+	freeLines(outputLines, outputAmount);
+	return same;
+}
+
+int checkServer(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	Investigation investigation;
+	investigation.touched = (RowIndex *) malloc(sizeof(RowIndex) * ALLOC_SIZE);
+	investigation.touchedCount = 0;
+	investigation.touchedCapacity = ALLOC_SIZE;
+	investigation.marks = (unsigned char *) calloc(sizeof(unsigned char), peopleListSize + 1);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *response = fopen(DIFF_MODE_FILE, "w");
+	int same = investigation.touched != NULL && investigation.marks != NULL &&
+			   meetingsFile != NULL && response != NULL;
+	if (same)
+	{
+		same = investigate(meetingsFile, &investigation, peopleList, peopleListSize) == NULL;
+		same = respond(response, &investigation, peopleList) == NULL && same;
+	}
+	if (meetingsFile != NULL)
+	{
+		fclose(meetingsFile);
+	}
+	if (response != NULL)
+	{
+		same = fclose(response) != EOF && same;
+	}
+	free(investigation.touched);
+	free(investigation.marks);
+	freePeople(peopleList, peopleListSize);
+	return same && sameUpToCleanOrder(FAILURE);
+}
+
+int checkExternal(void)
+{
+	return runExternal(DIFF_PEOPLE_FILE, DIFF_MEETINGS_FILE, DIFF_MODE_FILE,
+					   DIFF_EXTERNAL_BUDGET) == EXIT_SUCCESS &&
+		   sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+}
+
+int checkPrune(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	FILE *outputFile = meetingsFile != NULL ? fopen(DIFF_MODE_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFilePruned(meetingsFile, peopleList, peopleListSize);
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	static char *referenceLines[MAX_LINES];
+	static char *pruneLines[MAX_LINES];
+	int referenceAmount = readFileLines(DIFF_REFERENCE_FILE, referenceLines);
+	int pruneAmount = readFileLines(DIFF_MODE_FILE, pruneLines);
+	int same = referenceAmount >= 0 && referenceAmount == pruneAmount;
+	if (same)
+	{
+		qsort(referenceLines, referenceAmount, sizeof(char *), compareLines);
+		qsort(pruneLines, pruneAmount, sizeof(char *), compareLines);
+		for (int i = 0; same && i < referenceAmount; ++i)
+		{
+			same = strcmp(referenceLines[i], pruneLines[i]) == 0;
+		}
+	}
+	freeLines(referenceLines, referenceAmount);
+	freeLines(pruneLines, pruneAmount);
+	return same;
+}
+
+int writeBytes(const char *path, const char *bytes, size_t length)
+{
+	FILE *file = fopen(path, "w");
+	if (file == NULL)
+	{
+		return FAILURE;
+	}
+	int written = fwrite(bytes, 1, length, file) == length;
+	return fclose(file) != EOF && written;
+}
+
+int checkAlerts(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	if (meetingsFile == NULL || openAlerts(DIFF_ALERTS_FILE, peopleListSize) == FAILURE)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFile(meetingsFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	FILE *alertsFile = closeAlerts() ? fopen(DIFF_ALERTS_FILE, "r") : NULL;
+	FILE *expectedFile = fopen(DIFF_EXPECTED_ALERTS_FILE, "r");
+	int same = alertsFile != NULL && expectedFile != NULL;
+	while (same)
+	{
+		char alert[MAX_LINE_LENGTH];
+		char expected[MAX_LINE_LENGTH];
+		int hasAlert = fgets(alert, MAX_LINE_LENGTH, alertsFile) != NULL;
+		same = hasAlert == (fgets(expected, MAX_LINE_LENGTH, expectedFile) != NULL);
+		if (!hasAlert)
+		{
+			break;
+		}
+		// "ALERT <microseconds> " is dropped, the time isn't the reference's
+		char *time = strchr(alert, ' ');
+		char *rest = time != NULL ? strchr(time + 1, ' ') : NULL;
+		same = same && strncmp(alert, "ALERT ", time - alert + 1) == 0 && rest != NULL &&
+			   strcmp(rest + 1, expected) == 0;
+	}
+	if (alertsFile != NULL)
+	{
+		fclose(alertsFile);
+	}
+	if (expectedFile != NULL)
+	{
+		fclose(expectedFile);
+	}
+	return same;
+}
+
+int runIncremental(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_APPEND_FILE, "r");
+	FILE *outputFile = meetingsFile != NULL ? fopen(DIFF_MODE_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFileIncremental(meetingsFile, peopleList, peopleListSize, DIFF_CHECKPOINT_FILE);
+	sortByProbability(&peopleList, peopleListSize);
+	writeOutput(outputFile, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return SUCCESS;
+}
+
+int resumes(void)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(DIFF_APPEND_FILE, "r");
+	CheckpointHeader header;
+	int resumed = meetingsFile != NULL && loadCheckpoint(DIFF_CHECKPOINT_FILE, meetingsFile,
+														 peopleList, peopleListSize, &header);
+	if (meetingsFile != NULL)
+	{
+		fclose(meetingsFile);
+	}
+	freePeople(peopleList, peopleListSize);
+	return resumed;
+}
+
+int checkCheckpoint(uint64_t caseSeed)
+{
+	FILE *meetingsFile = fopen(DIFF_MEETINGS_FILE, "r");
+	long fileLength = -1;
+	if (meetingsFile != NULL && fseek(meetingsFile, 0, SEEK_END) == 0)
+	{
+		fileLength = ftell(meetingsFile);
+		rewind(meetingsFile);
+	}
+	char *meetings = fileLength >= 0 ? (char *) malloc((size_t) fileLength + 1) : NULL;
+	size_t length = meetings != NULL ? fread(meetings, 1, (size_t) fileLength, meetingsFile) : 0;
+	if (meetingsFile != NULL)
+	{
+		fclose(meetingsFile);
+	}
+	if (meetings == NULL)
+	{
+		return FAILURE;
+	}
+	meetings[length] = '\0';
+	// the sick person's line is whole in both runs, only the meetings are cut, unless the first
+	// run sees nothing at all
+	uint64_t state = caseSeed;
+	size_t cut = randomBelow(&state, 100) < EMPTY_CUT_PERCENT ? 0 : strcspn(meetings, "\n") + 1;
+	if (cut > 0 && cut < length)
+	{
+		cut += (size_t) randomBelow(&state, (int) (length - cut));
+	}
+	if (cut > 0 && cut < length && randomBelow(&state, 2) == 0) // at a line end, not in the middle
+	{
+		cut += strcspn(&meetings[cut], "\n") + 1;
+	}
+	cut = cut < length ? cut : length;
+	unlink(DIFF_CHECKPOINT_FILE);
+	int same = writeBytes(DIFF_APPEND_FILE, meetings, cut) && runIncremental() &&
+			   writeBytes(DIFF_APPEND_FILE, meetings, length) && resumes() && runIncremental() &&
+			   sameFiles(DIFF_REFERENCE_FILE, DIFF_MODE_FILE);
+	free(meetings);
+	return same;
+}
+
+int runDelta(const char *meetingsPath)
+{
+	size_t peopleListSize;
+	Person *peopleList = loadPeople(DIFF_PEOPLE_FILE, &peopleListSize);
+	FILE *meetingsFile = fopen(meetingsPath, "r");
+	FILE *outputFile = meetingsFile != NULL ? fopen(DIFF_DELTA_FILE, "w") : NULL;
+	if (outputFile == NULL)
+	{
+		beforeExitFailure(meetingsFile, OUT_FILE_ERROR, peopleList, peopleListSize);
+		return FAILURE;
+	}
+	readMeetingsFile(meetingsFile, peopleList, peopleListSize);
+	writeDeltaOutput(outputFile, DIFF_CLASSES_FILE, peopleList, peopleListSize);
+	freePeople(peopleList, peopleListSize);
+	return SUCCESS;
+}
+
+int isDifference(const char *newPath, const char *oldPath)
+{
+	static char *newLines[MAX_LINES];
+	static char *oldLines[MAX_LINES];
+	static char *deltaLines[MAX_LINES];
+	int newAmount = readFileLines(newPath, newLines);
+	int oldAmount = readFileLines(oldPath, oldLines);
+	int deltaAmount = readFileLines(DIFF_DELTA_FILE, deltaLines);
+	int same = newAmount >= 0 && oldAmount >= 0 && deltaAmount >= 0;
+	if (same)
+	{
+		qsort(oldLines, oldAmount, sizeof(char *), compareLines);
+		qsort(deltaLines, deltaAmount, sizeof(char *), compareLines);
+		qsort(newLines, newAmount, sizeof(char *), compareLines);
+		// both the new lines and the delta are sorted, so the difference is matched in order
+		int d = 0;
+		for (int i = 0; same && i < newAmount; ++i)
+		{
+			if (bsearch(&newLines[i], oldLines, oldAmount, sizeof(char *), compareLines) == NULL)
+			{
+				same = d < deltaAmount && strcmp(newLines[i], deltaLines[d]) == 0;
+				++d;
+			}
+		}
+		same = same && d == deltaAmount;
+	}
+	freeLines(newLines, newAmount);
+	freeLines(oldLines, oldAmount);
+	freeLines(deltaLines, deltaAmount);
+	return same;
+}
+
+int checkDelta(const DiffCase *const diffCase)
+{
+	unlink(DIFF_CLASSES_FILE);
+	if (writeMeetings(DIFF_LANE_FILE, diffCase, NULL, 0) == FAILURE ||
+		runReference(DIFF_LANE_FILE, DIFF_CLEAN_FILE, NULL) == FAILURE ||
+		runDelta(DIFF_MEETINGS_FILE) == FAILURE ||
+		!isDifference(DIFF_REFERENCE_FILE, DIFF_CLEAN_FILE))
+	{
+		return FAILURE;
+	}
+	// the last sick person is another one, unless the case has a single person
+	const unsigned long int *source = &diffCase->sources[diffCase->sourcesAmount - 1];
+	return writeMeetings(DIFF_LANE_FILE, diffCase, source, 1) &&
+		   runReference(DIFF_LANE_FILE, DIFF_MODE_FILE, NULL) && runDelta(DIFF_LANE_FILE) &&
+		   isDifference(DIFF_MODE_FILE, DIFF_REFERENCE_FILE);
+}
+
+char *cachePath(const char *option, const char *value)
+{
+	char *argv[7];
+	int argc = 0;
+	argv[argc++] = DIFF_PROGRAM;
+	argv[argc++] = CACHE_OPTION;
+	argv[argc++] = DIFF_CACHE_DIR;
+	if (option != NULL)
+	{
+		argv[argc++] = (char *) option;
+	}
+	if (value != NULL)
+	{
+		argv[argc++] = (char *) value;
+	}
+	argv[argc++] = DIFF_PEOPLE_FILE;
+	argv[argc++] = DIFF_APPEND_FILE;
+	Config config;
+	if (parseArguments(argc, argv, &config) == FAILURE)
+	{
+		return NULL;
+	}
+	return cachedOutputPath(config.cacheDir, argv[config.firstArg + PEOPLE_FILE_INDEX],
+							argv[config.firstArg + MEETINGS_FILE_INDEX], &config);
+}
+
+int checkCache(const DiffCase *const diffCase)
+{
+	char *path = writeMeetings(DIFF_APPEND_FILE, diffCase, diffCase->sources, 1) ?
+				 cachePath(NULL, NULL) : NULL;
+	if (path == NULL)
+	{
+		return FAILURE;
+	}
+	unlink(path); // the same files may have been cached by an earlier case
+	// a miss, the output is stored, and a hit writes it again
+	int right = !restoreCachedOutput(path) &&
+				runReference(DIFF_APPEND_FILE, DIFF_MODE_FILE, NULL) &&
+				runReference(DIFF_APPEND_FILE, OUTPUT_FILE, NULL) && storeCachedOutput(path) &&
+				unlink(OUTPUT_FILE) == 0 && restoreCachedOutput(path) &&
+				sameFiles(DIFF_MODE_FILE, OUTPUT_FILE);
+	const char *const options[CACHE_OPTIONS][2] = {
+			{BINARY_OPTION, NULL}, {PRUNE_OPTION, NULL}, {PIPELINE_OPTION, NULL},
+			{OVERLAP_OPTION, NULL}, {EXTERNAL_OPTION, NULL}, {THREADS_OPTION, "2"},
+			{STATS_OPTION, NULL}};
+	for (int i = 0; right && i < CACHE_OPTIONS; ++i)
+	{
+		char *optionPath = cachePath(options[i][0], options[i][1]);
+		// a binary file and prune mode change the output, the other modes write the same output
+		// as the regular mode, and --stats only watches the run
+		int changes = i < OUTPUT_CHANGING_OPTIONS;
+		right = optionPath != NULL && (strcmp(path, optionPath) != 0) == changes;
+		free(optionPath);
+	}
+	// the meetings of another sick person, in the same file
+	const unsigned long int *source = &diffCase->sources[diffCase->sourcesAmount - 1];
+	if (right && source != diffCase->sources)
+	{
+		char *changedPath = NULL;
+		right = writeMeetings(DIFF_APPEND_FILE, diffCase, source, 1) &&
+				(changedPath = cachePath(NULL, NULL)) != NULL && strcmp(path, changedPath) != 0 &&
+				!restoreCachedOutput(changedPath);
+		free(changedPath);
+	}
+	unlink(path);
+	free(path);
+	return right;
+}
+
+void removeFiles(const char *dir)
+{
+	const char *const files[] = {DIFF_PEOPLE_FILE, DIFF_MEETINGS_FILE, DIFF_SOURCES_FILE,
+								 DIFF_LANE_FILE, DIFF_BINARY_FILE, DIFF_REFERENCE_FILE,
+								 DIFF_MODE_FILE, DIFF_APPEND_FILE, DIFF_CHECKPOINT_FILE,
+								 DIFF_CLEAN_FILE, DIFF_CLASSES_FILE, DIFF_DELTA_FILE,
+								 OUTPUT_FILE, DIFF_EXPECTED_ALERTS_FILE, DIFF_ALERTS_FILE};
+	for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+	{
+		unlink(files[i]);
+	}
+	for (int job = 1; job <= DIFF_SOURCES; ++job)
+	{
+		char outputPath[BATCH_OUTPUT_LENGTH];
+		snprintf(outputPath, BATCH_OUTPUT_LENGTH, BATCH_OUTPUT_FILE, job);
+		unlink(outputPath);
+	}
+	rmdir(DIFF_CACHE_DIR);
+	if (chdir("/") == 0)
+	{
+		rmdir(dir);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int cases = DEFAULT_CASES;
+	uint64_t seed = DEFAULT_DIFF_SEED;
+	int maxPeople = DEFAULT_MAX_PEOPLE;
+	const char *dir = NULL;
+	for (int i = 1; i < argc; i += 2)
+	{
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, DIFF_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+		const char *value = argv[i + 1];
+		if (strcmp(argv[i], "--cases") == 0)
+		{
+			cases = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			seed = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--max-people") == 0)
+		{
+			maxPeople = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--dir") == 0)
+		{
+			dir = value;
+		}
+		else
+		{
+			fprintf(stderr, DIFF_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+	}
+	if (cases < 1 || maxPeople < 1 || maxPeople * MAX_MEETINGS_PER_PERSON >= MAX_LINES)
+	{
+		fprintf(stderr, DIFF_USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	// every mode writes its files to the working directory
+	char tempDir[] = "/tmp/spreader_difftest.XXXXXX";
+	if (dir == NULL)
+	{
+		dir = mkdtemp(tempDir);
+	}
+	if (dir == NULL || chdir(dir) != 0)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		return EXIT_FAILURE;
+	}
+	const char *const checkNames[] = {"text", "binary", "compact", "pipeline", "overlap", "batch",
+									  "multi-source", "server", "external", "prune", "checkpoint",
+									  "delta", "cache", "alerts"};
+	for (int i = 0; i < cases; ++i)
+	{
+		DiffCase diffCase;
+		memset(&diffCase, 0, sizeof(DiffCase));
+		uint64_t caseSeed = seed + i;
+		// one case in a hundred has no meetings at all, not even a sick person
+		int empty = caseSeed % 100 == 0;
+		if (generateCase(caseSeed, maxPeople, &diffCase) == FAILURE ||
+			writeMeetings(DIFF_MEETINGS_FILE, &diffCase, diffCase.sources, !empty) == FAILURE ||
+			runReference(DIFF_MEETINGS_FILE, DIFF_REFERENCE_FILE,
+						 DIFF_EXPECTED_ALERTS_FILE) == FAILURE)
+		{
+			fprintf(stderr, STANDARD_LIB_ERR_MSG);
+			return EXIT_FAILURE;
+		}
+		int results[] = {checkText(), checkBinary(), checkCompact(), checkPipeline(caseSeed),
+						 checkOverlap(), checkBatch(), empty || checkMultiSource(&diffCase),
+						 checkServer(), checkExternal(), checkPrune(),
+						 empty || checkCheckpoint(caseSeed), empty || checkDelta(&diffCase),
+						 checkCache(&diffCase), checkAlerts()};
+		free(diffCase.ids);
+		free(diffCase.meetings);
+		for (size_t check = 0; check < sizeof(results) / sizeof(results[0]); ++check)
+		{
+			if (!results[check])
+			{
+				fprintf(stderr, "case %d (--seed %llu --cases 1 --max-people %d): %s mode differs "
+								"from the reference, the files are in %s\n", i,
+						(unsigned long long) caseSeed, maxPeople, checkNames[check], dir);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	printf("%d cases, all the modes agree with the reference\n", cases);
+	if (dir == tempDir) // the files of a failure are kept, for reproducing it
+	{
+		removeFiles(dir);
+	}
+	return EXIT_SUCCESS;
+}
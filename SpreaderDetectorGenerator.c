@@ -0,0 +1,397 @@
+/**
+ * @file SpreaderDetectorGenerator.c
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief A generator of synthetic people's and meetings' files, for measuring the
+ * SpreaderDetectorBackend program without real data
+ *
+ * @section LICENSE
+ * This program is a free software.
+ *
+ * @section DESCRIPTION
+ * The generator writes a people's file and a meetings' file of any size, in the formats the
+ * SpreaderDetectorBackend program reads. Everything is derived from the seed, so the same
+ * parameters always generate the same files, and nothing is kept in memory, so the size is only
+ * limited by the disk.
+ */
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "SpreaderDetectorGenerator.h"
+#include "SpreaderDetectorParams.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def SUCCESS- a declaration for success in a function.
+ */
+#define SUCCESS 1
+
+/**
+ * @def FAILURE- a declaration for failure in a function.
+ */
+#define FAILURE 0
+
+/**
+ * @def ARGS_AMOUNT- the number of arguments in argv[] after the options
+ */
+#define ARGS_AMOUNT 3
+
+/**
+ * @def PEOPLE_FILE_INDEX- the people's file index in argv[] (after the options)
+ */
+#define PEOPLE_FILE_INDEX 1
+
+/**
+ * @def MEETINGS_FILE_INDEX- the meetings' file index in argv[] (after the options)
+ */
+#define MEETINGS_FILE_INDEX 2
+
+/**
+ * @def DECIMAL_BASE- a numeric base for the int convertion
+ */
+#define DECIMAL_BASE 10
+
+/**
+ * @def USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define USAGE_ERROR "USAGE: ./spreader_generator [--people <N>] [--meetings <N>] " \
+					"[--density <0-1>] [--name-min <N>] [--name-max <N>] [--exponent <X>] " \
+					"[--seed <N>] <Path to People.in> <Path to Meetings.in>\n"
+
+/**
+ * @def OUT_FILE_ERROR- the massage to print when there is an error in the output files
+ */
+#define OUT_FILE_ERROR "Error in output file.\n"
+
+/**
+ * @def MAX_NAME_LENGTH- the maximal length of a name, so a line fits in the backend's buffer
+ */
+#define MAX_NAME_LENGTH 512
+
+/**
+ * @def FIRST_ID- the smallest id that is generated
+ */
+#define FIRST_ID 100000000ull
+
+/**
+ * @def MAX_AGE_TENTHS- the ages are generated in tenths of a year, up to this value
+ */
+#define MAX_AGE_TENTHS 1000
+
+/**
+ * @def MAX_DISTANCE_FACTOR- the distances are generated up to MIN_DISTANCE times this factor
+ */
+#define MAX_DISTANCE_FACTOR 3.0
+
+/**
+ * @def LETTERS- the amount of letters in the alphabet of the names
+ */
+#define LETTERS 26
+
+/**
+ * @def PEOPLE_STREAM- the random stream of the people's fields
+ */
+#define PEOPLE_STREAM 1
+
+/**
+ * @def ORDER_STREAM- the random stream of the order of the people in the people's file
+ */
+#define ORDER_STREAM 2
+
+/**
+ * @def POPULARITY_STREAM- the random stream of the order of the people by their contacts
+ */
+#define POPULARITY_STREAM 3
+
+/**
+ * @def Permutation- a struct that contains a pseudo-random permutation of [0, size), computed one
+ * value at a time: an odd multiplier and an increment modulo a power of 2, walked until the value
+ * is inside the range
+ */
+typedef struct Permutation
+{
+	uint64_t size;
+	uint64_t mask;
+	uint64_t multiplier;
+	uint64_t increment;
+} Permutation;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function mixes a 64 bit value (the SplitMix64 finalizer), the source of all the randomness
+ * @param value - the value to mix
+ * @return the mixed value
+ */
+uint64_t mix64(uint64_t value);
+
+/**
+ * This function returns a random value in [0, 1), derived from a seed, a stream and an index
+ * @param seed - the generator's seed
+ * @param stream - the stream of the value
+ * @param index - the index of the value in the stream
+ * @return a double in [0, 1)
+ */
+double uniform(uint64_t seed, uint64_t stream, uint64_t index);
+
+/**
+ * This function initializes a pseudo-random permutation of [0, size)
+ * @param permutation - the struct to fill
+ * @param size - the size of the range
+ * @param seed - the generator's seed
+ * @param stream - the stream of the permutation
+ */
+void initPermutation(Permutation *permutation, uint64_t size, uint64_t seed, uint64_t stream);
+
+/**
+ * This function applies the permutation to a value
+ * @param permutation - the permutation
+ * @param value - a value in [0, size)
+ * @return the permuted value, also in [0, size)
+ */
+uint64_t permute(const Permutation *permutation, uint64_t value);
+
+/**
+ * This function returns the id of a person, increasing with the person's index and spread over the
+ * ids' range by the density
+ * @param params - the shape of the dataset
+ * @param person - the person's index
+ * @return the id
+ */
+unsigned long int personId(const GeneratorParams *params, uint64_t person);
+
+/**
+ * This function draws a rank from a power-law distribution over [0, size): rank r is drawn with a
+ * probability proportional to (r + 1) ^ -exponent
+ * @param size - the size of the range
+ * @param exponent - the exponent of the power-law
+ * @param random - a random value in [0, 1)
+ * @return the rank
+ */
+uint64_t powerLawRank(uint64_t size, double exponent, double random);
+
+/**
+ * This function writes a single line of the people's file
+ * @param params - the shape of the dataset
+ * @param person - the person's index
+ * @param peopleFile - the file to write to
+ * @return 1 if succeeded, 0 if failed
+ */
+int writeGeneratedPerson(const GeneratorParams *params, uint64_t person, FILE *peopleFile);
+
+//-------------------------------------------- code  -----------------------------------------------
+
+uint64_t mix64(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+double uniform(uint64_t seed, uint64_t stream, uint64_t index)
+{
+	uint64_t bits = mix64(mix64(seed ^ mix64(stream)) ^ index);
+	return (double) (bits >> 11) / (double) (1ull << 53);
+}
+
+void initPermutation(Permutation *const permutation, uint64_t size, uint64_t seed,
+					 uint64_t stream)
+{
+	uint64_t mask = 1;
+	while (mask < size)
+	{
+		mask <<= 1;
+	}
+	permutation->size = size;
+	permutation->mask = mask - 1;
+	permutation->multiplier = (mix64(seed ^ mix64(stream)) << 2) | 5; // a full period modulo 2^k
+	permutation->increment = mix64(seed + stream) | 1;
+}
+
+uint64_t permute(const Permutation *const permutation, uint64_t value)
+{
+	do
+	{
+		value = (value * permutation->multiplier + permutation->increment) & permutation->mask;
+	} while (value >= permutation->size);
+	return value;
+}
+
+unsigned long int personId(const GeneratorParams *const params, uint64_t person)
+{
+	double jitter = uniform(params->seed, PEOPLE_STREAM, person);
+	return (unsigned long int) (FIRST_ID + (uint64_t) ((person + jitter) / params->idDensity));
+}
+
+uint64_t powerLawRank(uint64_t size, double exponent, double random)
+{
+	double rank;
+	if (fabs(exponent - 1.0) < 1e-9)
+	{
+		rank = exp(random * log((double) size + 1.0));
+	}
+	else
+	{
+		double power = 1.0 - exponent;
+		rank = pow((pow((double) size + 1.0, power) - 1.0) * random + 1.0, 1.0 / power);
+	}
+	uint64_t result = rank < 1.0 ? 0 : (uint64_t) rank - 1;
+	return result < size ? result : size - 1;
+}
+
+int writeGeneratedPerson(const GeneratorParams *const params, uint64_t person,
+						 FILE *const peopleFile)
+{
+	char name[MAX_NAME_LENGTH + 1];
+	int nameRange = params->nameMax - params->nameMin + 1;
+	int length = params->nameMin +
+				 (int) (uniform(params->seed, PEOPLE_STREAM, ~person) * nameRange);
+	uint64_t letters = mix64(params->seed ^ mix64(person));
+	for (int i = 0; i < length; ++i)
+	{
+		if (i % 8 == 7)
+		{
+			letters = mix64(letters);
+		}
+		name[i] = (char) ((i == 0 ? 'A' : 'a') + (letters >> (8 * (i % 8))) % LETTERS);
+	}
+	name[length] = '\0';
+	int ageTenths = 1 + (int) (uniform(params->seed, PEOPLE_STREAM, person ^ (1ull << 63)) *
+							   MAX_AGE_TENTHS);
+	return fprintf(peopleFile, "%s %lu %d.%d\n", name, personId(params, person),
+				   ageTenths / DECIMAL_BASE, ageTenths % DECIMAL_BASE) > 0;
+}
+
+void defaultGeneratorParams(GeneratorParams *const params)
+{
+	params->peopleAmount = DEFAULT_PEOPLE;
+	params->meetingsAmount = DEFAULT_PEOPLE * DEFAULT_MEETINGS_PER_PERSON;
+	params->idDensity = DEFAULT_ID_DENSITY;
+	params->nameMin = DEFAULT_NAME_MIN;
+	params->nameMax = DEFAULT_NAME_MAX;
+	params->exponent = DEFAULT_EXPONENT;
+	params->seed = DEFAULT_SEED;
+}
+
+int generateDataset(const GeneratorParams *const params, FILE *const peopleFile,
+					FILE *const meetingsFile)
+{
+	if (params->peopleAmount == 0)
+	{
+		return SUCCESS;
+	}
+	Permutation order;
+	Permutation popularity;
+	initPermutation(&order, params->peopleAmount, params->seed, ORDER_STREAM);
+	initPermutation(&popularity, params->peopleAmount, params->seed, POPULARITY_STREAM);
+	for (uint64_t i = 0; i < params->peopleAmount; ++i)
+	{
+		if (writeGeneratedPerson(params, permute(&order, i), peopleFile) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	// the most popular person is the sick one
+	if (fprintf(meetingsFile, "%lu\n", personId(params, permute(&popularity, 0))) < 0)
+	{
+		return FAILURE;
+	}
+	for (uint64_t i = 0; i < params->meetingsAmount; ++i)
+	{
+		uint64_t infector = powerLawRank(params->peopleAmount, params->exponent,
+										 uniform(params->seed, POPULARITY_STREAM, 4 * i));
+		uint64_t infected = (uint64_t) (uniform(params->seed, POPULARITY_STREAM, 4 * i + 1) *
+										(double) params->peopleAmount);
+		double spread = uniform(params->seed, POPULARITY_STREAM, 4 * i + 2);
+		double distance = MIN_DISTANCE * (1.0 + (MAX_DISTANCE_FACTOR - 1.0) * spread);
+		double time = MAX_TIME * (1.0 - uniform(params->seed, POPULARITY_STREAM, 4 * i + 3));
+		if (fprintf(meetingsFile, "%lu %lu %.2f %.2f\n",
+					personId(params, permute(&popularity, infector)),
+					personId(params, permute(&popularity, infected)), distance, time) < 0)
+		{
+			return FAILURE;
+		}
+	}
+	return SUCCESS;
+}
+
+#ifndef SPREADER_DETECTOR_LIBRARY
+int main(int argc, char *argv[])
+{
+	GeneratorParams params;
+	defaultGeneratorParams(&params);
+	int meetingsSet = FAILURE;
+	int i = 1;
+	for (; i + 1 < argc && strncmp(argv[i], "--", 2) == 0; i += 2)
+	{
+		const char *value = argv[i + 1];
+		if (strcmp(argv[i], "--people") == 0)
+		{
+			params.peopleAmount = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--meetings") == 0)
+		{
+			params.meetingsAmount = strtoull(value, NULL, DECIMAL_BASE);
+			meetingsSet = SUCCESS;
+		}
+		else if (strcmp(argv[i], "--density") == 0)
+		{
+			params.idDensity = strtod(value, NULL);
+		}
+		else if (strcmp(argv[i], "--name-min") == 0)
+		{
+			params.nameMin = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--name-max") == 0)
+		{
+			params.nameMax = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--exponent") == 0)
+		{
+			params.exponent = strtod(value, NULL);
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			params.seed = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (!meetingsSet)
+	{
+		params.meetingsAmount = params.peopleAmount * DEFAULT_MEETINGS_PER_PERSON;
+	}
+	argv += i - 1;
+	if (argc - (i - 1) != ARGS_AMOUNT || !(params.idDensity > 0 && params.idDensity <= 1) ||
+		params.nameMin < 1 || params.nameMax < params.nameMin ||
+		params.nameMax > MAX_NAME_LENGTH || !(params.exponent > 0))
+	{
+		fprintf(stderr, USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	FILE *peopleFile = fopen(argv[PEOPLE_FILE_INDEX], "w");
+	FILE *meetingsFile = fopen(argv[MEETINGS_FILE_INDEX], "w");
+	int success = peopleFile != NULL && meetingsFile != NULL &&
+				  generateDataset(&params, peopleFile, meetingsFile);
+	if (peopleFile != NULL && fclose(peopleFile) == EOF)
+	{
+		success = FAILURE;
+	}
+	if (meetingsFile != NULL && fclose(meetingsFile) == EOF)
+	{
+		success = FAILURE;
+	}
+	if (!success)
+	{
+		fprintf(stderr, OUT_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+#endif //SPREADER_DETECTOR_LIBRARY
@@ -0,0 +1,91 @@
+/**
+ * @file SpreaderDetectorGenerator.h
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief A generator of synthetic people's and meetings' files, for measuring the
+ * SpreaderDetectorBackend program without real data
+ *
+ * @section LICENSE
+ * This program is a free software.
+ */
+
+#ifndef SPREADERDETECTORGENERATOR_H
+#define SPREADERDETECTORGENERATOR_H
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdio.h>
+#include <stdint.h>
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def DEFAULT_PEOPLE- the default amount of people to generate
+ */
+#define DEFAULT_PEOPLE 1000
+
+/**
+ * @def DEFAULT_MEETINGS_PER_PERSON- the default amount of meetings to generate for every person
+ */
+#define DEFAULT_MEETINGS_PER_PERSON 4
+
+/**
+ * @def DEFAULT_ID_DENSITY- the default part of the ids' range that is used by people
+ */
+#define DEFAULT_ID_DENSITY 0.5
+
+/**
+ * @def DEFAULT_NAME_MIN- the default minimal length of a name
+ */
+#define DEFAULT_NAME_MIN 3
+
+/**
+ * @def DEFAULT_NAME_MAX- the default maximal length of a name
+ */
+#define DEFAULT_NAME_MAX 12
+
+/**
+ * @def DEFAULT_EXPONENT- the default exponent of the power-law of the contacts' degrees
+ */
+#define DEFAULT_EXPONENT 2.0
+
+/**
+ * @def DEFAULT_SEED- the default seed of the generator
+ */
+#define DEFAULT_SEED 2020
+
+/**
+ * @def GeneratorParams- a struct that contains the shape of a dataset to generate. The same
+ * parameters always generate the same files
+ */
+typedef struct GeneratorParams
+{
+	uint64_t peopleAmount;
+	uint64_t meetingsAmount;
+	double idDensity;
+	int nameMin;
+	int nameMax;
+	double exponent;
+	uint64_t seed;
+} GeneratorParams;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function fills the parameters with the defaults
+ * @param params - the struct to fill
+ */
+void defaultGeneratorParams(GeneratorParams *params);
+
+/**
+ * This function generates a people's file and a meetings' file. The people are written in a
+ * shuffled order, their ids spread over the ids' range by the density, and the meetings pick their
+ * infectors by a power-law, so a few people have many contacts and most have a few. The sick person
+ * is the one with the most contacts
+ * @param params - the shape of the dataset
+ * @param peopleFile - the people's file to write to (not closed)
+ * @param meetingsFile - the meetings' file to write to (not closed)
+ * @return 1 if succeeded, 0 if failed
+ */
+int generateDataset(const GeneratorParams *params, FILE *peopleFile, FILE *meetingsFile);
+
+#endif //SPREADERDETECTORGENERATOR_H
@@ -0,0 +1,511 @@
+/**
+ * @file SpreaderDetectorMicroBenchmark.c
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief Micro-benchmarks of the hot functions of the SpreaderDetectorBackend program
+ *
+ * @section LICENSE
+ * This program is a free software.
+ *
+ * @section DESCRIPTION
+ * Every benchmark isolates a single function of the backend: crna(), findRow(), fillPerson(),
+ * probUpdater(), mergeSort() with every comparator and the formatting of the output's lines. The
+ * inputs are generated in memory by SpreaderDetectorGenerator. Every benchmark runs a few warmup
+ * repetitions and then the measured ones, and the time per operation is reported by percentiles, so
+ * an optimization of any of these functions can be checked against a stable baseline.
+ */
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include "SpreaderDetectorBackend.h"
+#include "SpreaderDetectorGenerator.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def MICRO_USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define MICRO_USAGE_ERROR "USAGE: ./spreader_microbench [--people <N>] [--reps <N>] " \
+						  "[--warmup <N>] [--seed <N>] [--format table|csv] [--filter <name>]\n"
+
+/**
+ * @def DEFAULT_MICRO_PEOPLE- the default amount of people in the generated input
+ */
+#define DEFAULT_MICRO_PEOPLE 100000
+
+/**
+ * @def DEFAULT_REPS- the default amount of measured repetitions of every benchmark
+ */
+#define DEFAULT_REPS 30
+
+/**
+ * @def DEFAULT_WARMUP- the default amount of warmup repetitions of every benchmark
+ */
+#define DEFAULT_WARMUP 3
+
+/**
+ * @def NANOS_PER_SECOND- the amount of nanoseconds in a second
+ */
+#define NANOS_PER_SECOND 1000000000.0
+
+/**
+ * @def PERCENT- the percentiles are given in percents
+ */
+#define PERCENT 100.0
+
+/**
+ * @def NULL_DEVICE- the file the output's lines are formatted into
+ */
+#define NULL_DEVICE "/dev/null"
+
+/**
+ * @def MicroContext- a struct that contains the inputs of the benchmarks, generated once
+ */
+typedef struct MicroContext
+{
+	char **peopleLines;
+	char **meetingsLines;
+	int peopleAmount;
+	int meetingsAmount;
+	Person *sortedPeople;
+	Person *shuffledPeople;
+	Person *workPeople;
+	Person *draftPeople;
+	float *distances;
+	float *times;
+	unsigned long int *queries;
+	FILE *sink;
+	double checksum;
+} MicroContext;
+
+/**
+ * @def MicroBenchmark- a struct that describes a single benchmark
+ */
+typedef struct MicroBenchmark
+{
+	const char *name;
+	void (*prepare)(MicroContext *context);
+	int (*run)(MicroContext *context);
+} MicroBenchmark;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function splits the content of a file to lines
+ * @param file - the file, closed at the end
+ * @param amount - the amount of lines, set by the function
+ * @return an array of lines (every line ends with '\n'), NULL if failed
+ */
+char **readLines(FILE *file, int *amount);
+
+/**
+ * This function generates the inputs of the benchmarks
+ * @param context - the struct to fill
+ * @param params - the shape of the generated dataset
+ * @return 1 if succeeded, 0 if failed
+ */
+int initContext(MicroContext *context, const GeneratorParams *params);
+
+/**
+ * This function compares two doubles, for qsort()
+ * @param a - a pointer to the first double
+ * @param b - a pointer to the second double
+ * @return a negative number, 0 or a positive number, as a is smaller, equal or greater than b
+ */
+int compareDoubles(const void *a, const void *b);
+
+/**
+ * This function returns a percentile of sorted samples
+ * @param samples - the samples, sorted
+ * @param amount - the amount of samples
+ * @param rank - the percentile, in percents
+ * @return the value of the percentile
+ */
+double percentile(const double *samples, int amount, double rank);
+
+/**
+ * This function does nothing, for benchmarks that don't need a preparation before every repetition
+ * @param context - the inputs
+ */
+void prepareNothing(MicroContext *context);
+
+/**
+ * This function copies the shuffled people to the work array, so every repetition of a sort starts
+ * from the same order
+ * @param context - the inputs
+ */
+void prepareShuffled(MicroContext *context);
+
+/**
+ * This function copies the people sorted by id to the work array, so every repetition of a sort by
+ * probability starts from the same order as in the program
+ * @param context - the inputs
+ */
+void prepareSortedById(MicroContext *context);
+
+/**
+ * This function resets the probabilities of the sorted people before a repetition of probUpdater()
+ * @param context - the inputs
+ */
+void prepareProbabilities(MicroContext *context);
+
+/**
+ * The benchmark of crna(), over the distances and the times of all the meetings
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runCrna(MicroContext *context);
+
+/**
+ * The benchmark of findRow(), over the ids of all the meetings
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runFindRow(MicroContext *context);
+
+/**
+ * The benchmark of fillPerson(), over all the lines of the people's file
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runFillPerson(MicroContext *context);
+
+/**
+ * The benchmark of probUpdater(), over all the lines of the meetings' file
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runProbUpdater(MicroContext *context);
+
+/**
+ * The benchmark of mergeSortById(), over the people in the file's order
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runSortById(MicroContext *context);
+
+/**
+ * The benchmark of mergeSort() with probCompare(), over the people sorted by id
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runSortByProbability(MicroContext *context);
+
+/**
+ * The benchmark of formatting the output's lines (writePerson()), for all the people
+ * @param context - the inputs
+ * @return the amount of operations
+ */
+int runWritePerson(MicroContext *context);
+
+//-------------------------------------------- code  -----------------------------------------------
+
+char **readLines(FILE *file, int *amount)
+{
+	int capacity = ALLOC_SIZE;
+	char **lines = (char **) malloc(sizeof(char *) * capacity);
+	char line[MAX_LINE_LENGTH];
+	*amount = 0;
+	rewind(file);
+	while (lines != NULL && fgets(line, MAX_LINE_LENGTH, file))
+	{
+		if (*amount == capacity)
+		{
+			capacity *= ALLOC_SIZE;
+			char **temp = (char **) realloc(lines, sizeof(char *) * capacity);
+			if (temp == NULL)
+			{
+				free(lines);
+				lines = NULL;
+				break;
+			}
+			lines = temp;
+		}
+		lines[*amount] = strdup(line);
+		++*amount;
+	}
+	fclose(file);
+	return lines;
+}
+
+int initContext(MicroContext *const context, const GeneratorParams *const params)
+{
+	memset(context, 0, sizeof(MicroContext));
+	FILE *peopleFile = tmpfile();
+	FILE *meetingsFile = tmpfile();
+	if (peopleFile == NULL || meetingsFile == NULL ||
+		generateDataset(params, peopleFile, meetingsFile) == FAILURE)
+	{
+		return FAILURE;
+	}
+	context->peopleLines = readLines(peopleFile, &context->peopleAmount);
+	context->meetingsLines = readLines(meetingsFile, &context->meetingsAmount);
+	if (context->peopleLines == NULL || context->meetingsLines == NULL ||
+		context->meetingsAmount < 1)
+	{
+		return FAILURE;
+	}
+	// the first line of the meetings is the sick id, the rest are the meetings
+	--context->meetingsAmount;
+	++context->meetingsLines;
+	int people = context->peopleAmount;
+	int meetings = context->meetingsAmount;
+	context->sortedPeople = (Person *) calloc(sizeof(Person), people + 1);
+	context->shuffledPeople = (Person *) calloc(sizeof(Person), people + 1);
+	context->workPeople = (Person *) calloc(sizeof(Person), people + 1);
+	context->draftPeople = (Person *) calloc(sizeof(Person), people + 1);
+	context->distances = (float *) malloc(sizeof(float) * (meetings + 1));
+	context->times = (float *) malloc(sizeof(float) * (meetings + 1));
+	context->queries = (unsigned long int *) malloc(sizeof(unsigned long int) * (meetings + 1));
+	context->sink = fopen(NULL_DEVICE, "w");
+	if (context->sortedPeople == NULL || context->shuffledPeople == NULL ||
+		context->workPeople == NULL || context->draftPeople == NULL ||
+		context->distances == NULL || context->times == NULL || context->queries == NULL ||
+		context->sink == NULL)
+	{
+		return FAILURE;
+	}
+	char line[MAX_LINE_LENGTH];
+	for (int i = 0; i < people; ++i)
+	{
+		strcpy(line, context->peopleLines[i]);
+		if (fillPerson(line, &context->shuffledPeople[i]) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	memcpy(context->sortedPeople, context->shuffledPeople, sizeof(Person) * people);
+	mergeSortById(context->sortedPeople, context->draftPeople, people, 0);
+	for (int i = 0; i < meetings; ++i)
+	{
+		char *rest = NULL;
+		strcpy(line, context->meetingsLines[i]);
+		context->queries[i] = strtoul(strtok_r(line, SEPARATOR, &rest), NULL, DECIMAL_BASE);
+		strtok_r(NULL, SEPARATOR, &rest);
+		context->distances[i] = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+		context->times[i] = strtof(strtok_r(NULL, SEPARATOR, &rest), NULL);
+	}
+	return SUCCESS;
+}
+
+int compareDoubles(const void *a, const void *b)
+{
+	double first = *(const double *) a;
+	double second = *(const double *) b;
+	return (first > second) - (first < second);
+}
+
+double percentile(const double *const samples, int amount, double rank)
+{
+	int index = (int) (rank / PERCENT * (amount - 1) + 0.5);
+	return samples[index];
+}
+
+void prepareNothing(MicroContext *const context)
+{
+	(void) context;
+}
+
+void prepareShuffled(MicroContext *const context)
+{
+	memcpy(context->workPeople, context->shuffledPeople, sizeof(Person) * context->peopleAmount);
+}
+
+void prepareSortedById(MicroContext *const context)
+{
+	memcpy(context->workPeople, context->sortedPeople, sizeof(Person) * context->peopleAmount);
+}
+
+void prepareProbabilities(MicroContext *const context)
+{
+	for (int i = 0; i < context->peopleAmount; ++i)
+	{
+		context->sortedPeople[i].probability = 0;
+	}
+	context->sortedPeople[0].probability = 1;
+}
+
+int runCrna(MicroContext *const context)
+{
+	float sum = 0;
+	for (int i = 0; i < context->meetingsAmount; ++i)
+	{
+		sum += crna(context->distances[i], context->times[i]);
+	}
+	context->checksum += sum;
+	return context->meetingsAmount;
+}
+
+int runFindRow(MicroContext *const context)
+{
+	long sum = 0;
+	for (int i = 0; i < context->meetingsAmount; ++i)
+	{
+		sum += findRow(context->sortedPeople, context->peopleAmount, context->queries[i]);
+	}
+	context->checksum += sum;
+	return context->meetingsAmount;
+}
+
+int runFillPerson(MicroContext *const context)
+{
+	char line[MAX_LINE_LENGTH];
+	for (int i = 0; i < context->peopleAmount; ++i)
+	{
+		strcpy(line, context->peopleLines[i]);
+		Person person;
+		if (fillPerson(line, &person) == SUCCESS)
+		{
+			context->checksum += person.age;
+			free(person.name);
+		}
+	}
+	return context->peopleAmount;
+}
+
+int runProbUpdater(MicroContext *const context)
+{
+	char line[MAX_LINE_LENGTH];
+	for (int i = 0; i < context->meetingsAmount; ++i)
+	{
+		strcpy(line, context->meetingsLines[i]);
+		probUpdater(context->sortedPeople, context->peopleAmount, line);
+	}
+	context->checksum += context->sortedPeople[0].probability;
+	return context->meetingsAmount;
+}
+
+int runSortById(MicroContext *const context)
+{
+	mergeSortById(context->workPeople, context->draftPeople, context->peopleAmount, 0);
+	context->checksum += context->workPeople[0].age;
+	return context->peopleAmount;
+}
+
+int runSortByProbability(MicroContext *const context)
+{
+	mergeSort(context->workPeople, context->draftPeople, context->peopleAmount, 0, probCompare);
+	context->checksum += context->workPeople[0].age;
+	return context->peopleAmount;
+}
+
+int runWritePerson(MicroContext *const context)
+{
+	for (int i = 0; i < context->peopleAmount; ++i)
+	{
+		// the probabilities are spread over all the classifications
+		float probability = (float) (i % 10) / 10;
+		writePerson(context->sink, &context->sortedPeople[i], probability);
+	}
+	return context->peopleAmount;
+}
+
+int main(int argc, char *argv[])
+{
+	GeneratorParams params;
+	defaultGeneratorParams(&params);
+	params.peopleAmount = DEFAULT_MICRO_PEOPLE;
+	int reps = DEFAULT_REPS;
+	int warmup = DEFAULT_WARMUP;
+	int csv = FAILURE;
+	const char *filter = NULL;
+	for (int i = 1; i < argc; i += 2)
+	{
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, MICRO_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+		const char *value = argv[i + 1];
+		if (strcmp(argv[i], "--people") == 0)
+		{
+			params.peopleAmount = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--reps") == 0)
+		{
+			reps = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--warmup") == 0)
+		{
+			warmup = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			params.seed = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i], "--format") == 0 &&
+				 (strcmp(value, "table") == 0 || strcmp(value, "csv") == 0))
+		{
+			csv = strcmp(value, "csv") == 0;
+		}
+		else if (strcmp(argv[i], "--filter") == 0)
+		{
+			filter = value;
+		}
+		else
+		{
+			fprintf(stderr, MICRO_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+	}
+	if (params.peopleAmount < 1 || reps < 1 || warmup < 0)
+	{
+		fprintf(stderr, MICRO_USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	params.meetingsAmount = params.peopleAmount * DEFAULT_MEETINGS_PER_PERSON;
+	MicroContext context;
+	if (initContext(&context, &params) == FAILURE)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		return EXIT_FAILURE;
+	}
+	const MicroBenchmark benchmarks[] = {{"crna", prepareNothing, runCrna},
+										 {"findRow", prepareNothing, runFindRow},
+										 {"fillPerson", prepareNothing, runFillPerson},
+										 {"probUpdater", prepareProbabilities, runProbUpdater},
+										 {"mergeSortById", prepareShuffled, runSortById},
+										 {"mergeSort/probCompare", prepareSortedById,
+										  runSortByProbability},
+										 {"writePerson", prepareNothing, runWritePerson}};
+	double *samples = (double *) malloc(sizeof(double) * reps);
+	if (samples == NULL)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		return EXIT_FAILURE;
+	}
+	printf(csv ? "benchmark,ops,min_ns,p50_ns,p90_ns,p99_ns,max_ns\n" :
+		   "%-22s %10s %10s %10s %10s %10s %10s   (ns per operation)\n", "benchmark", "ops",
+		   "min", "p50", "p90", "p99", "max");
+	for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); ++b)
+	{
+		const MicroBenchmark *benchmark = &benchmarks[b];
+		if (filter != NULL && strstr(benchmark->name, filter) == NULL)
+		{
+			continue;
+		}
+		int ops = 0;
+		for (int rep = 0; rep < warmup + reps; ++rep)
+		{
+			benchmark->prepare(&context);
+			double start = monotonicSeconds();
+			ops = benchmark->run(&context);
+			double seconds = monotonicSeconds() - start;
+			if (rep >= warmup)
+			{
+				samples[rep - warmup] = seconds * NANOS_PER_SECOND / (ops > 0 ? ops : 1);
+			}
+		}
+		qsort(samples, reps, sizeof(double), compareDoubles);
+		printf(csv ? "%s,%d,%.2f,%.2f,%.2f,%.2f,%.2f\n" :
+			   "%-22s %10d %10.2f %10.2f %10.2f %10.2f %10.2f\n", benchmark->name, ops,
+			   samples[0], percentile(samples, reps, 50), percentile(samples, reps, 90),
+			   percentile(samples, reps, 99), samples[reps - 1]);
+		fflush(stdout);
+	}
+	// the checksum keeps the compiler from removing the measured work
+	fprintf(stderr, "checksum %g\n", context.checksum);
+	free(samples);
+	return EXIT_SUCCESS;
+}
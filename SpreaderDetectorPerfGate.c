@@ -0,0 +1,453 @@
+/**
+ * @file SpreaderDetectorPerfGate.c
+ * @author  Shahar Ariel <shahar.ariel1@mail.huji.ac.il>
+ * @version 1.0
+ * @date 03 August 2020
+ *
+ * @brief A performance regression gate of the SpreaderDetectorBackend program
+ *
+ * @section LICENSE
+ * This program is a free software.
+ *
+ * @section DESCRIPTION
+ * The gate generates a dataset with a fixed seed (by SpreaderDetectorGenerator), runs the program
+ * on it in a few workloads (the regular, binary and prune modes) with --stats, and reads the rows/s
+ * of every phase from the report. Right before every run, the gate times a calibration loop of its
+ * own (formatting, parsing and merge sorting rows, apart from the backend), and every phase is
+ * measured by the ratio of its rows/s to the loop's, so a slower or a busier machine slows both
+ * sides of the ratio. The median ratio of a few runs is compared to the baseline file: a phase
+ * whose ratio is below its baseline's by more than the tolerance fails the gate. With --update,
+ * the baseline file is written from the measurements instead.
+ */
+
+//-----------------------------------------  includes  ---------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "SpreaderDetectorBackend.h"
+#include "SpreaderDetectorGenerator.h"
+
+//-------------------------------------  const definitions  ----------------------------------------
+/**
+ * @def GATE_USAGE_ERROR- the massage to print when there is a usage error
+ */
+#define GATE_USAGE_ERROR "USAGE: ./spreader_perfgate --program <Path to c_exam> " \
+						 "--baseline <Path to baseline> [--tolerance <0-1>] [--runs <N>] " \
+						 "[--people <N>] [--dir <Path>] [--update]\n"
+
+/**
+ * @def DEFAULT_TOLERANCE- the default part of the baseline's throughput a phase may lose
+ */
+#define DEFAULT_TOLERANCE 0.3
+
+/**
+ * @def DEFAULT_RUNS- the default amount of runs of every workload (the median one is compared)
+ */
+#define DEFAULT_RUNS 5
+
+/**
+ * @def MAX_GATE_RUNS- the maximal amount of runs of every workload
+ */
+#define MAX_GATE_RUNS 31
+
+/**
+ * @def CALIBRATION_ROWS- the amount of rows of the calibration loop
+ */
+#define CALIBRATION_ROWS (1 << 18)
+
+/**
+ * @def CALIBRATION_REPEATS- the amount of times the loop is timed before a run (the best counts)
+ */
+#define CALIBRATION_REPEATS 3
+
+/**
+ * @def DEFAULT_GATE_PEOPLE- the default amount of people in the dataset
+ */
+#define DEFAULT_GATE_PEOPLE 300000
+
+/**
+ * @def GATE_SEED- the seed of the dataset, fixed so the baseline stays comparable
+ */
+#define GATE_SEED 2020
+
+/**
+ * @def WORKLOADS- the amount of workloads
+ */
+#define WORKLOADS 3
+
+/**
+ * @def GATE_PHASES- the amount of phases of a workload
+ */
+#define GATE_PHASES 5
+
+/**
+ * @def COMMAND_LENGTH- the maximal length of a command
+ */
+#define COMMAND_LENGTH 8192
+
+/**
+ * @def NAME_LENGTH- the maximal length of a phase's name
+ */
+#define NAME_LENGTH 64
+
+/**
+ * @def GATE_PEOPLE_FILE- the people's file of the gate, in its directory
+ */
+#define GATE_PEOPLE_FILE "gate_people.in"
+
+/**
+ * @def GATE_MEETINGS_FILE- the meetings' file of the gate, in its directory
+ */
+#define GATE_MEETINGS_FILE "gate_meetings.in"
+
+/**
+ * @def GATE_BINARY_FILE- the binary meetings' file of the gate, in its directory
+ */
+#define GATE_BINARY_FILE "gate_meetings.bin"
+
+/**
+ * @def TOTAL_LINE- the line of the report that follows the phases
+ */
+#define TOTAL_LINE "total"
+
+/**
+ * @def Workload- a struct that describes a run of the program
+ */
+typedef struct Workload
+{
+	const char *name;
+	const char *options;
+	const char *meetingsFile;
+} Workload;
+
+/**
+ * @def Measurement- a struct that contains the throughput of a phase of a workload in every run,
+ * and its ratio to the calibration loop's
+ */
+typedef struct Measurement
+{
+	char phase[NAME_LENGTH];
+	double rowsPerSecond[MAX_GATE_RUNS];
+	double ratios[MAX_GATE_RUNS];
+} Measurement;
+
+//-----------------------------------------  functions  --------------------------------------------
+/**
+ * This function times the calibration loop: it formats rows of a person, parses them back and
+ * merge sorts them by id, the same kinds of work as the program's phases
+ * @param ids - an array of CALIBRATION_ROWS ids
+ * @param draft - a draft array of CALIBRATION_ROWS ids
+ * @return the rows/s of the loop, the best of CALIBRATION_REPEATS times
+ */
+double calibrate(unsigned long int *ids, unsigned long int *draft);
+
+/**
+ * This function runs a workload once and reads the throughput of its phases
+ * @param program - the path of the program
+ * @param workload - the workload
+ * @param run - the index of the run
+ * @param calibration - the rows/s of the calibration loop, timed right before the run
+ * @param measurements - an array of GATE_PHASES measurements to fill at the index of the run
+ * @return the amount of phases read, 0 if the run failed
+ */
+int runWorkload(const char *program, const Workload *workload, int run, double calibration,
+				Measurement *measurements);
+
+/**
+ * This function finds the median of an array of numbers
+ * @param values - the numbers, sorted by the function
+ * @param length - the amount of numbers
+ * @return the median
+ */
+double median(double *values, int length);
+
+/**
+ * This function compares two numbers, for qsort()
+ * @param a - a pointer to the first number
+ * @param b - a pointer to the second number
+ * @return a negative number, 0 or a positive number, like strcmp()
+ */
+int doubleCompare(const void *a, const void *b);
+
+/**
+ * This function finds the baseline of a phase of a workload
+ * @param baseline - the baseline file
+ * @param workload - the name of the workload
+ * @param phase - the name of the phase
+ * @return the ratio of the baseline, 0 if there's no baseline for the phase
+ */
+double findBaseline(FILE *baseline, const char *workload, const char *phase);
+
+//-------------------------------------------- code  -----------------------------------------------
+
+double calibrate(unsigned long int *const ids, unsigned long int *const draft)
+{
+	double best = 0;
+	for (int repeat = 0; repeat < CALIBRATION_REPEATS; ++repeat)
+	{
+		double start = monotonicSeconds();
+		unsigned long int state = GATE_SEED;
+		for (int i = 0; i < CALIBRATION_ROWS; ++i)
+		{
+			char line[MAX_LINE_LENGTH];
+			state = state * 6364136223846793005ul + 1442695040888963407ul;
+			snprintf(line, MAX_LINE_LENGTH, "person%d %lu %.1f\n", i, state >> 16,
+					 (double) (state % 1000) / 10);
+			char *rest = NULL;
+			ids[i] = strtoul(strchr(line, ' ') + 1, &rest, DECIMAL_BASE);
+			ids[i] += (unsigned long int) strtof(rest, NULL);
+		}
+		// a bottom-up merge sort, from runs of one id to the whole array
+		unsigned long int *from = ids;
+		unsigned long int *to = draft;
+		for (int width = 1; width < CALIBRATION_ROWS; width *= 2)
+		{
+			for (int low = 0; low < CALIBRATION_ROWS; low += 2 * width)
+			{
+				int mid = low + width < CALIBRATION_ROWS ? low + width : CALIBRATION_ROWS;
+				int high = mid + width < CALIBRATION_ROWS ? mid + width : CALIBRATION_ROWS;
+				int a = low;
+				int b = mid;
+				for (int i = low; i < high; ++i)
+				{
+					to[i] = b >= high || (a < mid && from[a] <= from[b]) ? from[a++] : from[b++];
+				}
+			}
+			unsigned long int *temp = from;
+			from = to;
+			to = temp;
+		}
+		double seconds = monotonicSeconds() - start;
+		// the sorted ids are used, so the loop isn't optimized away
+		if (seconds > 0 && from[0] <= from[CALIBRATION_ROWS - 1] &&
+			CALIBRATION_ROWS / seconds > best)
+		{
+			best = CALIBRATION_ROWS / seconds;
+		}
+	}
+	return best;
+}
+
+int runWorkload(const char *program, const Workload *const workload, int run, double calibration,
+				Measurement *const measurements)
+{
+	char command[COMMAND_LENGTH];
+	snprintf(command, COMMAND_LENGTH, "'%s' --stats %s %s %s 2>&1 >/dev/null", program,
+			 workload->options, GATE_PEOPLE_FILE, workload->meetingsFile);
+	FILE *report = popen(command, "r");
+	if (report == NULL)
+	{
+		return FAILURE;
+	}
+	char line[MAX_LINE_LENGTH];
+	int phases = 0;
+	while (fgets(line, MAX_LINE_LENGTH, report) != NULL &&
+		   strncmp(line, TOTAL_LINE, strlen(TOTAL_LINE)) != 0)
+	{
+		char phase[NAME_LENGTH];
+		double seconds;
+		unsigned long long rows;
+		double rowsPerSecond;
+		if (phases < GATE_PHASES &&
+			sscanf(line, "%63s %lf %llu %lf", phase, &seconds, &rows, &rowsPerSecond) == 4)
+		{
+			strcpy(measurements[phases].phase, phase);
+			measurements[phases].rowsPerSecond[run] = rowsPerSecond;
+			measurements[phases].ratios[run] = rowsPerSecond / calibration;
+			++phases;
+		}
+	}
+	while (fgets(line, MAX_LINE_LENGTH, report) != NULL)
+	{
+		// the rest of the report isn't measured
+	}
+	return pclose(report) == 0 ? phases : FAILURE;
+}
+
+int doubleCompare(const void *a, const void *b)
+{
+	double first = *(const double *) a;
+	double second = *(const double *) b;
+	return (first > second) - (first < second);
+}
+
+double median(double *const values, int length)
+{
+	qsort(values, length, sizeof(double), doubleCompare);
+	return length % 2 == 1 ? values[length / 2] : (values[length / 2 - 1] + values[length / 2]) / 2;
+}
+
+double findBaseline(FILE *const baseline, const char *workload, const char *phase)
+{
+	rewind(baseline);
+	char line[MAX_LINE_LENGTH];
+	while (fgets(line, MAX_LINE_LENGTH, baseline) != NULL)
+	{
+		char lineWorkload[NAME_LENGTH];
+		char linePhase[NAME_LENGTH];
+		double ratio;
+		if (line[0] != '#' && sscanf(line, "%63s %63s %lf", lineWorkload, linePhase, &ratio) == 3 &&
+			strcmp(lineWorkload, workload) == 0 && strcmp(linePhase, phase) == 0)
+		{
+			return ratio;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *program = NULL;
+	const char *baselinePath = NULL;
+	const char *dir = ".";
+	double tolerance = DEFAULT_TOLERANCE;
+	int runs = DEFAULT_RUNS;
+	int update = FAILURE;
+	GeneratorParams params;
+	defaultGeneratorParams(&params);
+	params.peopleAmount = DEFAULT_GATE_PEOPLE;
+	params.seed = GATE_SEED;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--update") == 0)
+		{
+			update = SUCCESS;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, GATE_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+		const char *value = argv[++i];
+		if (strcmp(argv[i - 1], "--program") == 0)
+		{
+			program = value;
+		}
+		else if (strcmp(argv[i - 1], "--baseline") == 0)
+		{
+			baselinePath = value;
+		}
+		else if (strcmp(argv[i - 1], "--tolerance") == 0)
+		{
+			tolerance = strtod(value, NULL);
+		}
+		else if (strcmp(argv[i - 1], "--runs") == 0)
+		{
+			runs = (int) strtol(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i - 1], "--people") == 0)
+		{
+			params.peopleAmount = strtoull(value, NULL, DECIMAL_BASE);
+		}
+		else if (strcmp(argv[i - 1], "--dir") == 0)
+		{
+			dir = value;
+		}
+		else
+		{
+			fprintf(stderr, GATE_USAGE_ERROR);
+			return EXIT_FAILURE;
+		}
+	}
+	if (program == NULL || baselinePath == NULL || tolerance < 0 || tolerance >= 1 || runs < 1 ||
+		runs > MAX_GATE_RUNS || params.peopleAmount == 0)
+	{
+		fprintf(stderr, GATE_USAGE_ERROR);
+		return EXIT_FAILURE;
+	}
+	params.meetingsAmount = params.peopleAmount * DEFAULT_MEETINGS_PER_PERSON;
+	// the baseline is opened before moving to the gate's directory, so a relative path works
+	FILE *baseline = fopen(baselinePath, update ? "w" : "r");
+	if (baseline == NULL || chdir(dir) != 0)
+	{
+		fprintf(stderr, update ? OUT_FILE_ERROR : IN_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	FILE *peopleFile = fopen(GATE_PEOPLE_FILE, "w");
+	FILE *meetingsFile = fopen(GATE_MEETINGS_FILE, "w");
+	int success = peopleFile != NULL && meetingsFile != NULL &&
+				  generateDataset(&params, peopleFile, meetingsFile);
+	success = (peopleFile == NULL || fclose(peopleFile) != EOF) && success;
+	success = (meetingsFile == NULL || fclose(meetingsFile) != EOF) && success;
+	char command[COMMAND_LENGTH];
+	snprintf(command, COMMAND_LENGTH, "'%s' --convert %s %s %s", program, GATE_PEOPLE_FILE,
+			 GATE_MEETINGS_FILE, GATE_BINARY_FILE);
+	if (!success || system(command) != 0)
+	{
+		fprintf(stderr, OUT_FILE_ERROR);
+		fclose(baseline);
+		return EXIT_FAILURE;
+	}
+	unsigned long int *ids = (unsigned long int *) malloc(sizeof(unsigned long int) *
+														  CALIBRATION_ROWS * 2);
+	if (ids == NULL)
+	{
+		fprintf(stderr, STANDARD_LIB_ERR_MSG);
+		fclose(baseline);
+		return EXIT_FAILURE;
+	}
+	const Workload workloads[WORKLOADS] = {{"regular", "", GATE_MEETINGS_FILE},
+										   {"binary", BINARY_OPTION, GATE_BINARY_FILE},
+										   {"prune", PRUNE_OPTION, GATE_MEETINGS_FILE}};
+	if (update)
+	{
+		fprintf(baseline, "# workload phase ratio to the calibration loop, the median of %d "
+						  "runs on %llu people (seed %d)\n", runs,
+				(unsigned long long) params.peopleAmount, GATE_SEED);
+	}
+	int regressions = 0;
+	for (int w = 0; w < WORKLOADS; ++w)
+	{
+		Measurement measurements[GATE_PHASES];
+		memset(measurements, 0, sizeof(measurements));
+		int phases = 0;
+		// the first run only warms the caches up: the next one overwrites its measurements
+		for (int run = -1; run < runs; ++run)
+		{
+			double calibration = calibrate(ids, ids + CALIBRATION_ROWS);
+			phases = calibration > 0 ? runWorkload(program, &workloads[w], run < 0 ? 0 : run,
+													calibration, measurements) : FAILURE;
+			if (phases == FAILURE)
+			{
+				fprintf(stderr, "%s: the run failed\n", workloads[w].name);
+				free(ids);
+				fclose(baseline);
+				return EXIT_FAILURE;
+			}
+		}
+		for (int p = 0; p < phases; ++p)
+		{
+			Measurement *measurement = &measurements[p];
+			double rowsPerSecond = median(measurement->rowsPerSecond, runs);
+			double ratio = median(measurement->ratios, runs);
+			if (update)
+			{
+				fprintf(baseline, "%s %s %.4f\n", workloads[w].name, measurement->phase, ratio);
+				continue;
+			}
+			double expected = findBaseline(baseline, workloads[w].name, measurement->phase);
+			int regressed = expected > 0 && ratio < expected * (1 - tolerance);
+			regressions += regressed;
+			printf("%-8s %-18s %14.0f rows/s, ratio %8.4f, baseline %8.4f (%+6.1f%%)%s\n",
+				   workloads[w].name, measurement->phase, rowsPerSecond, ratio, expected,
+				   expected > 0 ? (ratio / expected - 1) * 100 : 0,
+				   regressed ? "  REGRESSION" : "");
+		}
+	}
+	free(ids);
+	if (fclose(baseline) == EOF)
+	{
+		fprintf(stderr, OUT_FILE_ERROR);
+		return EXIT_FAILURE;
+	}
+	if (regressions > 0)
+	{
+		fprintf(stderr, "%d phases regressed beyond the tolerance of %.0f%%\n", regressions,
+				tolerance * 100);
+		return EXIT_FAILURE;
+	}
+	printf(update ? "The baseline was written to %s\n" : "No regression against %s\n",
+		   baselinePath);
+	return EXIT_SUCCESS;
+}